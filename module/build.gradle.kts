@@ -46,7 +46,27 @@ fun getPrebuiltPath(): String {
     return "$ndkPath/toolchains/llvm/prebuilt/${osName}-x86_64/bin"
 }
 
-fun compileLogmonitor(variantName: String, buildDir: File) {
+// Single-source C++ tools under cpp/, built as <name>-<moduleId>-<target>
+val nativeCppTools = listOf(
+    "logmonitor",
+    "zramctl",
+    "zrambench",
+    "swapbench",
+    "swapscan",
+    "blockstate",
+    "governor"
+)
+
+// Per-tool flags on top of the common ones. logmonitor stays up for the whole uptime and
+// ships the lean build; its footprint budget lives in cpp/logger_lean.hpp.
+val nativeToolFlags = mapOf(
+    "logmonitor" to listOf(
+        "-DLOGMONITOR_LEAN", "-fno-exceptions", "-fno-rtti",
+        "-ffunction-sections", "-fdata-sections", "-Wl,--gc-sections", "-s"
+    )
+)
+
+fun compileCppTools(variantName: String, buildDir: File) {
     if (ndkPath == null) {
         logger.warn("ANDROID_NDK_HOME not set, skipping native binary compilation")
         return
@@ -56,24 +76,29 @@ fun compileLogmonitor(variantName: String, buildDir: File) {
     val binDir = File(buildDir, "bin")
     binDir.mkdirs()
 
-    val logmonitorSource = File(projectDir, "cpp/logmonitor.cpp")
-    if (logmonitorSource.exists()) {
+    nativeCppTools.forEach { toolName ->
+        val toolSource = File(projectDir, "cpp/$toolName.cpp")
+        if (!toolSource.exists()) {
+            logger.warn("Source file not found: ${toolSource.absolutePath}")
+            return@forEach
+        }
         targetMappings.forEach { (abi, target) ->
             val compiler = compilerMappings_cpp[abi]
-            val outputFile = File(binDir, "logmonitor-${moduleId}-${target}")
+            val outputFile = File(binDir, "$toolName-${moduleId}-${target}")
             val cmd = listOf(
                 "$prebuiltPath/$compiler",
                 "-O3", "-flto", "-std=c++20", "-Wall", "-Wextra", "-static-libstdc++",
-                "-I", "${projectDir}/cpp",
+                "-I", "${projectDir}/cpp"
+            ) + nativeToolFlags[toolName].orEmpty() + listOf(
                 "-o", outputFile.absolutePath,
-                logmonitorSource.absolutePath
+                toolSource.absolutePath
             )
             
-            logger.lifecycle("Compiling logmonitor for $abi ($target)...")
+            logger.lifecycle("Compiling $toolName for $abi ($target)...")
             val process = Runtime.getRuntime().exec(cmd.toTypedArray())
             process.waitFor()
             if (process.exitValue() != 0) {
-                logger.lifecycle("Error compiling logmonitor for $abi")
+                logger.lifecycle("Error compiling $toolName for $abi")
             }
         }
     }
@@ -173,6 +198,11 @@ fun compileFilewatcher(variantName: String, buildDir: File) {
         if (builtBinary.exists()) {
             builtBinary.copyTo(outputFile, overwrite = true)
         }
+
+        val builtAurorad = File(buildDirAbi, "src/aurorad")
+        if (builtAurorad.exists()) {
+            builtAurorad.copyTo(File(binDir, "aurorad-${moduleId}-${target}"), overwrite = true)
+        }
         
         buildDirAbi.deleteRecursively()
     }
@@ -379,7 +409,7 @@ listOf("debug", "release").forEach { variantName ->
     val compileNativeTask = tasks.register("compileNative$variantCapped") {
         group = "module"
         doLast {
-            compileLogmonitor(variantName, layout.buildDirectory.get().asFile)
+            compileCppTools(variantName, layout.buildDirectory.get().asFile)
             compileFilewatcher(variantName, layout.buildDirectory.get().asFile)
             compileF2fspin(variantName, layout.buildDirectory.get().asFile)
             compileUtilLinux(variantName, layout.buildDirectory.get().asFile)
@@ -0,0 +1,281 @@
+#include "zram_sysfs.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <ctime>
+
+// Linux-specific headers
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Streaming analyzer for /sys/kernel/debug/zram/<dev>/block_state
+// (CONFIG_ZRAM_MEMORY_TRACKING). Each line is
+//   "%12zd %12lu.%06lu <flags>\n"  index, access time (CLOCK_BOOTTIME), s/w/h/i/n flags
+// and a multi-GB device has millions of them, so the file is parsed in fixed chunks
+// with a vectorized newline scan and nothing per slot is kept except the buckets.
+
+using zram::Clock;
+
+constexpr size_t kChunkSize = 1 << 20;
+constexpr int kBuckets = 24;            // log2 seconds: [0,1) [1,2) [2,4) .. [2^22, inf)
+constexpr unsigned long long kPageSize = 4096;
+
+enum Flag { kSame, kWritten, kHuge, kIdle, kIncompressible, kFlagCount };
+
+struct Bucket {
+    unsigned long long slots{0};
+    unsigned long long huge{0};         // stored uncompressed, a full page each
+    unsigned long long resident{0};     // neither same-filled nor already written back
+};
+
+struct Analysis {
+    unsigned long long slots{0};
+    unsigned long long malformed{0};
+    unsigned long long flags[kFlagCount]{};
+    Bucket buckets[kBuckets];
+};
+
+struct Options {
+    std::string device{"zram0"};
+    std::string file;
+    double now{0};          // seconds of CLOCK_BOOTTIME, 0 = current
+    double avg_bytes{0};    // compressed bytes per normal slot, 0 = from mm_stat
+};
+
+// Bucket = bit width of the age in whole seconds, no floating point per slot
+static int age_bucket(std::uint64_t age_s) noexcept {
+    if (age_s == 0) return 0;
+    const int bucket = 64 - __builtin_clzll(age_s);
+    return std::min(bucket, kBuckets - 1);
+}
+
+static long bucket_min_seconds(int bucket) noexcept {
+    return bucket == 0 ? 0 : 1L << (bucket - 1);
+}
+
+// Bitmask of '\n' positions in 16 bytes; kMaskStride bits per byte
+#if defined(__ARM_NEON)
+constexpr int kMaskStride = 4;
+static inline std::uint64_t newline_mask(const char* p) noexcept {
+    const uint8x16_t eq = vceqq_u8(vld1q_u8(reinterpret_cast<const std::uint8_t*>(p)), vdupq_n_u8('\n'));
+    const uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) & 0x8888888888888888ULL;
+}
+#elif defined(__SSE2__)
+constexpr int kMaskStride = 1;
+static inline std::uint64_t newline_mask(const char* p) noexcept {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))));
+}
+#endif
+
+static inline const char* skip_spaces(const char* p, const char* end) noexcept {
+    while (p < end && *p == ' ') ++p;
+    return p;
+}
+
+static void parse_line(const char* p, const char* end, std::uint64_t now_us, Analysis& out) noexcept {
+    // Index column is not needed, only its end
+    p = skip_spaces(p, end);
+    while (p < end && *p >= '0' && *p <= '9') ++p;
+    p = skip_spaces(p, end);
+
+    unsigned long long sec = 0;
+    const char* digits = p;
+    while (p < end && *p >= '0' && *p <= '9') sec = sec * 10 + static_cast<unsigned>(*p++ - '0');
+    if (p == digits || p >= end || *p != '.') {
+        out.malformed++;
+        return;
+    }
+    unsigned usec = 0;
+    for (++p; p < end && *p >= '0' && *p <= '9'; ++p) usec = usec * 10 + static_cast<unsigned>(*p - '0');
+    p = skip_spaces(p, end);
+
+    bool same = false, written = false, huge = false;
+    for (; p < end; ++p) {
+        switch (*p) {
+            case 's': out.flags[kSame]++; same = true; break;
+            case 'w': out.flags[kWritten]++; written = true; break;
+            case 'h': out.flags[kHuge]++; huge = true; break;
+            case 'i': out.flags[kIdle]++; break;
+            case 'n': out.flags[kIncompressible]++; break;
+            default: break;
+        }
+    }
+
+    const std::uint64_t stamp_us = sec * 1000000 + usec;
+    Bucket& bucket = out.buckets[age_bucket(now_us > stamp_us ? (now_us - stamp_us) / 1000000 : 0)];
+    bucket.slots++;
+    if (!same && !written) {
+        bucket.resident++;
+        if (huge) bucket.huge++;
+    }
+    out.slots++;
+}
+
+// Parse every complete line in [begin, end), return where the trailing partial line starts
+static const char* scan_chunk(const char* begin, const char* end, std::uint64_t now_us, Analysis& out) noexcept {
+    const char* line = begin;
+    const char* p = begin;
+#if defined(__ARM_NEON) || defined(__SSE2__)
+    for (; p + 16 <= end; p += 16) {
+        for (std::uint64_t mask = newline_mask(p); mask; mask &= mask - 1) {
+            const char* nl = p + __builtin_ctzll(mask) / kMaskStride;
+            parse_line(line, nl, now_us, out);
+            line = nl + 1;
+        }
+    }
+#endif
+    while (const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)))) {
+        parse_line(line, nl, now_us, out);
+        line = p = nl + 1;
+    }
+    return line;
+}
+
+static bool analyze(int fd, std::uint64_t now_us, Analysis& out) {
+    // One extra byte so a final line without '\n' can be terminated in place
+    std::unique_ptr<char[]> buf{new char[kChunkSize + 1]};
+    size_t carry = 0;
+    for (;;) {
+        const ssize_t len = read(fd, buf.get() + carry, kChunkSize - carry);
+        if (len < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (len == 0) break;
+        const char* end = buf.get() + carry + len;
+        const char* rest = scan_chunk(buf.get(), end, now_us, out);
+        carry = static_cast<size_t>(end - rest);
+        if (carry == kChunkSize) return false;  // no newline in a whole chunk
+        std::memmove(buf.get(), rest, carry);
+    }
+    if (carry > 0) {
+        buf[carry] = '\n';
+        scan_chunk(buf.get(), buf.get() + carry + 1, now_us, out);
+    }
+    return true;
+}
+
+static double boottime_now() noexcept {
+    timespec ts{};
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+    return static_cast<double>(ts.tv_sec) + ts.tv_nsec / 1e9;
+}
+
+// Average compressed size of a normal (not huge, not same-filled) resident slot
+static double average_slot_bytes(const std::string& device, const Analysis& a) noexcept {
+    zram::MmStat mm;
+    if (!zram::read_mm_stat(device, mm)) return 0;
+    unsigned long long resident = 0, huge = 0;
+    for (const auto& bucket : a.buckets) {
+        resident += bucket.resident;
+        huge += bucket.huge;
+    }
+    const unsigned long long normal = resident - huge;
+    const unsigned long long huge_bytes = huge * kPageSize;
+    if (normal == 0 || mm.compr_data_size <= huge_bytes) return 0;
+    return static_cast<double>(mm.compr_data_size - huge_bytes) / static_cast<double>(normal);
+}
+
+static void write_report(const Options& opt, const Analysis& a, double avg_bytes, double elapsed) {
+    std::printf("{\"device\":\"%s\",\"elapsed_ms\":%.2f,\"slots\":%llu,\"malformed\":%llu,",
+                opt.device.c_str(), elapsed, a.slots, a.malformed);
+    std::printf("\"flags\":{\"same\":%llu,\"written_back\":%llu,\"huge\":%llu,\"idle\":%llu,\"incompressible\":%llu},",
+                a.flags[kSame], a.flags[kWritten], a.flags[kHuge], a.flags[kIdle], a.flags[kIncompressible]);
+    std::printf("\"avg_compressed_bytes\":%.1f,", avg_bytes);
+
+    int last = kBuckets - 1;
+    while (last > 0 && a.buckets[last].slots == 0) --last;
+
+    std::printf("\"age_histogram\":[");
+    for (int b = 0; b <= last; ++b) {
+        std::printf("%s{\"min_s\":%ld,\"max_s\":", b ? "," : "", bucket_min_seconds(b));
+        if (b + 1 < kBuckets) std::printf("%ld", bucket_min_seconds(b + 1));
+        else std::printf("null");
+        std::printf(",\"slots\":%llu}", a.buckets[b].slots);
+    }
+
+    // Writeback at age >= T frees every resident slot at least T old: huge slots a full
+    // page each, normal slots their average compressed size
+    std::printf("],\"writeback_curve\":[");
+    unsigned long long pages = 0, huge = 0;
+    std::vector<std::pair<unsigned long long, unsigned long long>> cumulative(static_cast<size_t>(last + 1));
+    for (int b = last; b >= 0; --b) {
+        pages += a.buckets[b].resident;
+        huge += a.buckets[b].huge;
+        cumulative[static_cast<size_t>(b)] = {pages, huge};
+    }
+    for (int b = 0; b <= last; ++b) {
+        const auto [resident, huge_pages] = cumulative[static_cast<size_t>(b)];
+        const auto bytes = static_cast<unsigned long long>(huge_pages * kPageSize + (resident - huge_pages) * avg_bytes);
+        std::printf("%s{\"age_s\":%ld,\"pages\":%llu,\"huge_pages\":%llu,\"bytes\":%llu}",
+                    b ? "," : "", bucket_min_seconds(b), resident, huge_pages, bytes);
+    }
+    std::printf("]}\n");
+}
+
+static void print_usage(const char* prog) noexcept {
+    std::printf("Usage: %s [options] [device]\n", prog);
+    std::printf("Options:\n");
+    std::printf("  -f FILE    Read a saved block_state instead of debugfs\n");
+    std::printf("  -T SEC     CLOCK_BOOTTIME seconds to measure ages against (default: now)\n");
+    std::printf("  -c BYTES   Average compressed bytes per slot (default: from mm_stat)\n");
+    std::printf("  -h         Show help\n");
+    std::printf("\nDevice defaults to zram0. Needs CONFIG_ZRAM_MEMORY_TRACKING and debugfs.\n");
+}
+
+int main(int argc, char* argv[]) {
+    Options opt;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        if (arg == "-f" && i + 1 < argc) opt.file = argv[++i];
+        else if (arg == "-T" && i + 1 < argc) opt.now = std::atof(argv[++i]);
+        else if (arg == "-c" && i + 1 < argc) opt.avg_bytes = std::atof(argv[++i]);
+        else if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg.starts_with("-")) {
+            std::fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            return 1;
+        } else {
+            opt.device = arg.substr(arg.rfind('/') + 1);
+        }
+    }
+
+    const std::string path = opt.file.empty() ? "/sys/kernel/debug/zram/" + opt.device + "/block_state" : opt.file;
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::fprintf(stderr, "Cannot open: %s (%s)\n", path.c_str(), strerror(errno));
+        return 1;
+    }
+
+    const auto start = Clock::now();
+    const double now = opt.now > 0 ? opt.now : boottime_now();
+    Analysis analysis;
+    const bool ok = analyze(fd, static_cast<std::uint64_t>(now * 1e6), analysis);
+    close(fd);
+    if (!ok) {
+        std::fprintf(stderr, "Failed to read: %s (%s)\n", path.c_str(), strerror(errno));
+        return 1;
+    }
+
+    const double avg_bytes = opt.avg_bytes > 0 ? opt.avg_bytes : average_slot_bytes(opt.device, analysis);
+    write_report(opt, analysis, avg_bytes, zram::elapsed_ms(start));
+    return 0;
+}
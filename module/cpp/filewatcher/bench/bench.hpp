@@ -0,0 +1,97 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+
+// Host benchmark suite for the native helpers. Every case adds one result line to a
+// JSON report; `id` is stable across builds so two reports can be compared.
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+inline std::uint64_t elapsed_ns(Clock::time_point start, Clock::time_point end = Clock::now()) noexcept {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+// Exact per-operation latencies; percentiles sort a copy once
+class Latencies {
+public:
+    void reserve(size_t n) { ns_.reserve(n); }
+    void add(std::uint64_t ns) { ns_.push_back(ns); }
+    void merge(const Latencies& other) { ns_.insert(ns_.end(), other.ns_.begin(), other.ns_.end()); }
+    size_t size() const noexcept { return ns_.size(); }
+
+    void finish() { std::sort(ns_.begin(), ns_.end()); }
+
+    // Requires finish()
+    std::uint64_t percentile(double q) const noexcept {
+        if (ns_.empty()) return 0;
+        const auto index = static_cast<size_t>(q * static_cast<double>(ns_.size() - 1) + 0.5);
+        return ns_[std::min(index, ns_.size() - 1)];
+    }
+
+private:
+    std::vector<std::uint64_t> ns_;
+};
+
+struct Options {
+    bool quick{false};
+    int max_threads{8};
+    std::string tmp_base;          // tmpfs when available
+    std::string logmonitor;        // shipped (lean) logmonitor for the shell and footprint cases
+    std::string logmonitor_full;   // threaded logger.hpp build, footprint comparison only
+    std::string filewatcher;
+    std::string aurorad;
+    std::string logger_sh;         // module's default_scripts/logger.sh
+    std::vector<std::string> only; // case id prefixes to run, empty = all
+};
+
+class Report {
+public:
+    // `extra` holds additional JSON members without braces, e.g. "\"rotations\":3". Without
+    // latencies (whole-run timings only) the row carries no percentile members at all
+    void add(std::string id, std::uint64_t ops, double seconds, Latencies* latencies, std::string extra = {});
+
+    bool write(const std::string& path, const Options& opt) const;
+
+    // Whether a baseline report was taken in the same -q mode as this run
+    static bool comparable(const std::string& baseline_path, const Options& opt);
+
+    // Returns the number of cases that regressed against the baseline report, counting
+    // selected baseline cases that did not run; -1 when the baseline cannot be read
+    int compare(const std::string& baseline_path, const Options& opt, double throughput_drop, double latency_rise) const;
+
+    // Hard limits (footprint budgets) that make the run fail regardless of any baseline
+    void fail(std::string reason) { failures_.push_back(std::move(reason)); }
+    const std::vector<std::string>& failures() const noexcept { return failures_; }
+
+private:
+    struct Row {
+        std::string id;
+        std::uint64_t ops;
+        double seconds;
+        double ops_per_s;
+        bool has_latency;
+        std::uint64_t p50, p90, p99, p999, max;
+        std::string extra;
+    };
+    std::vector<Row> rows_;
+    std::vector<std::string> failures_;
+};
+
+// Case ids are "<group>.<case>/<variant>"; -c prefixes can stop anywhere in them
+bool selected(const Options& opt, std::string_view id);
+bool group_selected(const Options& opt, std::string_view group);
+std::string make_temp_dir(const Options& opt, const char* tag);
+void remove_tree(const std::string& path);
+bool is_tmpfs(const std::string& path);
+
+void run_logger(const Options& opt, Report& report);
+void run_watcher(const Options& opt, Report& report);
+void run_shell(const Options& opt, Report& report);
+void run_footprint(const Options& opt, Report& report);
+
+} // namespace bench
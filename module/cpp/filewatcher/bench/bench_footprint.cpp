@@ -0,0 +1,165 @@
+#include "bench.hpp"
+#include "logger_lean.hpp"
+#include <string>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+// Linux-specific headers
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+// Resident memory and binary size of logmonitor, the process that stays up for the
+// whole uptime. The shipped lean build is checked against the budget in
+// logger_lean.hpp; the threaded build is measured alongside for comparison:
+//   footprint.logmonitor/lean   --logmonitor (budgeted)
+//   footprint.logmonitor/full   --logmonitor-full
+// Each row times one-shot `-c write` calls and adds the idle daemon's memory.
+namespace bench {
+
+namespace {
+
+struct Memory {
+    long rss_kb{-1};
+    long anon_kb{-1};
+    long private_dirty_kb{-1};
+    long pss_kb{-1};
+};
+
+long field_kb(const std::string& path, const char* key) {
+    FILE* fp = std::fopen(path.c_str(), "re");
+    if (!fp) return -1;
+    char line[256];
+    long value = -1;
+    const size_t key_len = std::strlen(key);
+    while (value < 0 && std::fgets(line, sizeof(line), fp)) {
+        if (std::strncmp(line, key, key_len) == 0 && line[key_len] == ':') value = std::atol(line + key_len + 1);
+    }
+    std::fclose(fp);
+    return value;
+}
+
+Memory read_memory(pid_t pid) {
+    const std::string base = "/proc/" + std::to_string(pid);
+    Memory mem;
+    mem.rss_kb = field_kb(base + "/status", "VmRSS");
+    mem.anon_kb = field_kb(base + "/status", "RssAnon");
+    // Dirty private pages, anonymous or COW'd data: what reclaim has to push into zram
+    mem.private_dirty_kb = field_kb(base + "/smaps_rollup", "Private_Dirty");
+    mem.pss_kb = field_kb(base + "/smaps_rollup", "Pss");
+    return mem;
+}
+
+pid_t spawn(const std::string& binary, const std::string& dir, const char* command, const char* message) {
+    const pid_t pid = fork();
+    if (pid == 0) {
+        const int null = open("/dev/null", O_WRONLY);
+        dup2(null, STDOUT_FILENO);
+        if (message) {
+            execl(binary.c_str(), "logmonitor", "-d", dir.c_str(), "-c", command, "-n", "bench", "-m", message,
+                  static_cast<char*>(nullptr));
+        } else {
+            execl(binary.c_str(), "logmonitor", "-d", dir.c_str(), "-c", command, static_cast<char*>(nullptr));
+        }
+        _exit(127);
+    }
+    return pid;
+}
+
+Memory measure_daemon(const Options& opt, const std::string& binary) {
+    // A freshly linked binary still has dirty page cache, and its mapped text would count
+    // as Private_Dirty until writeback; write it back first
+    const int fd = open(binary.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+    const std::string dir = make_temp_dir(opt, "footprint");
+    Memory mem;
+    const pid_t pid = spawn(binary, dir, "daemon", nullptr);
+    if (pid > 0) {
+        // Past startup and the first log line, well before the first idle flush
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        mem = read_memory(pid);
+        kill(pid, SIGTERM);
+        waitpid(pid, nullptr, 0);
+    }
+    remove_tree(dir);
+    return mem;
+}
+
+void footprint_case(const Options& opt, Report& report, const char* variant, const std::string& binary,
+                    bool budgeted) {
+    const std::string id = std::string("footprint.logmonitor/") + variant;
+    if (!selected(opt, id)) return;
+    struct stat st;
+    if (binary.empty() || stat(binary.c_str(), &st) != 0 || access(binary.c_str(), X_OK) != 0) {
+        std::printf("  footprint.logmonitor/%s skipped (no binary)\n", variant);
+        // The budget is the point of this case: an unchecked budget must not pass
+        if (budgeted) report.fail("no logmonitor binary to check against the budget (--logmonitor)");
+        return;
+    }
+    const long binary_kb = static_cast<long>((st.st_size + 1023) / 1024);
+    const Memory daemon = measure_daemon(opt, binary);
+
+    const size_t calls = opt.quick ? 50 : 300;
+    const std::string dir = make_temp_dir(opt, "footprint");
+    Latencies lat;
+    long peak_kb = 0;
+    const auto start = Clock::now();
+    for (size_t i = 0; i < calls; ++i) {
+        const auto call = Clock::now();
+        const pid_t pid = spawn(binary, dir, "write", "footprint bench message");
+        int status = 0;
+        rusage usage{};
+        if (pid > 0 && wait4(pid, &status, 0, &usage) == pid) {
+            peak_kb = std::max(peak_kb, usage.ru_maxrss);
+        }
+        lat.add(elapsed_ns(call));
+    }
+    const double seconds = static_cast<double>(elapsed_ns(start)) / 1e9;
+    remove_tree(dir);
+
+    char extra[384];
+    const int len = std::snprintf(extra, sizeof(extra),
+                            "\"binary_kb\":%ld,\"daemon_rss_kb\":%ld,\"daemon_anon_kb\":%ld,"
+                            "\"daemon_private_dirty_kb\":%ld,\"daemon_pss_kb\":%ld,\"write_peak_rss_kb\":%ld",
+                            binary_kb, daemon.rss_kb, daemon.anon_kb, daemon.private_dirty_kb, daemon.pss_kb, peak_kb);
+    if (budgeted) {
+        const long private_budget = static_cast<long>(LeanLogger::kPrivateDirtyBudgetKb);
+        const long binary_budget = static_cast<long>(LeanLogger::kBinaryBudgetKb);
+        const bool memory_ok = daemon.private_dirty_kb >= 0 && daemon.private_dirty_kb <= private_budget;
+        const bool binary_ok = binary_kb <= binary_budget;
+        std::snprintf(extra + len, sizeof(extra) - static_cast<size_t>(len),
+                      ",\"private_dirty_budget_kb\":%ld,\"binary_budget_kb\":%ld,\"within_budget\":%s",
+                      private_budget, binary_budget, memory_ok && binary_ok ? "true" : "false");
+        if (!memory_ok) {
+            report.fail("logmonitor daemon Private_Dirty " + std::to_string(daemon.private_dirty_kb) +
+                        " kB exceeds the " + std::to_string(private_budget) + " kB budget");
+        }
+        if (!binary_ok) {
+            report.fail("logmonitor binary " + std::to_string(binary_kb) + " kB exceeds the " +
+                        std::to_string(binary_budget) + " kB budget");
+        }
+    }
+    report.add(id, calls, seconds, &lat, extra);
+    std::printf("    binary %ld kB, idle daemon Private_Dirty %ld kB, RssAnon %ld kB\n", binary_kb,
+                daemon.private_dirty_kb, daemon.anon_kb);
+}
+
+} // namespace
+
+void run_footprint(const Options& opt, Report& report) {
+    if (!group_selected(opt, "footprint")) return;
+    std::printf("Footprint:\n");
+    footprint_case(opt, report, "lean", opt.logmonitor, true);
+    footprint_case(opt, report, "full", opt.logmonitor_full, false);
+}
+
+} // namespace bench
@@ -0,0 +1,129 @@
+#include "bench.hpp"
+#include "logger.hpp"
+#include "stats.hpp"
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstdio>
+
+// Linux-specific headers
+#include <sys/stat.h>
+
+// Logger::write_log / batch_write from 1..N producer threads, with and without low
+// power mode, plus a small size limit to keep rotation on the hot path.
+namespace bench {
+
+namespace {
+
+constexpr size_t kBatchSize = 32;
+const std::string kMessage = "zram0 reconfigured: algorithm=lz4 disksize=4294967296 streams=8 pressure=62:41";
+
+std::uint64_t counter_value(const char* name) {
+    for (const auto& [key, value] : stats::Registry::instance().snapshot().counters) {
+        if (key == name) return value;
+    }
+    return 0;
+}
+
+struct CaseConfig {
+    const char* name;
+    int threads;
+    bool low_power;
+    bool batch;
+    size_t size_limit;
+    size_t lines;        // total across threads
+};
+
+void run_case(const Options& opt, Report& report, const CaseConfig& c) {
+    char id[96];
+    std::snprintf(id, sizeof(id), "%s/t%d%s", c.name, c.threads, c.low_power ? "/lp" : "");
+    if (!selected(opt, id)) return;
+
+    const std::string dir = make_temp_dir(opt, "logger");
+    const std::uint64_t flushes_before = counter_value("log.flushes");
+    const std::uint64_t rotations_before = counter_value("log.rotations");
+    const std::uint64_t bytes_before = counter_value("log.flushed_bytes");
+
+    const size_t per_thread = c.lines / static_cast<size_t>(c.threads);
+    const size_t ops_per_thread = c.batch ? per_thread / kBatchSize : per_thread;
+    std::vector<Latencies> latencies(static_cast<size_t>(c.threads));
+    double seconds = 0;
+    {
+        Logger logger(dir, LogLevel::INFO, c.size_limit);
+        logger.set_low_power_mode(c.low_power);
+
+        std::atomic<int> ready{0};
+        std::atomic<bool> go{false};
+        std::vector<std::thread> producers;
+        const std::vector<std::pair<LogLevel, std::string>> entries(kBatchSize, {LogLevel::INFO, kMessage});
+
+        for (int t = 0; t < c.threads; ++t) {
+            producers.emplace_back([&, t] {
+                Latencies& lat = latencies[static_cast<size_t>(t)];
+                lat.reserve(ops_per_thread);
+                ready.fetch_add(1);
+                while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+                for (size_t i = 0; i < ops_per_thread; ++i) {
+                    const auto start = Clock::now();
+                    if (c.batch) logger.batch_write("bench", entries);
+                    else logger.write_log("bench", LogLevel::INFO, kMessage);
+                    lat.add(elapsed_ns(start));
+                }
+            });
+        }
+        while (ready.load() < c.threads) std::this_thread::yield();
+
+        const auto start = Clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto& producer : producers) producer.join();
+        logger.flush_all();
+        seconds = static_cast<double>(elapsed_ns(start)) / 1e9;
+    }
+
+    Latencies all;
+    for (const auto& lat : latencies) all.merge(lat);
+    const size_t total_lines = ops_per_thread * static_cast<size_t>(c.threads) * (c.batch ? kBatchSize : 1);
+
+    const std::uint64_t flushes = counter_value("log.flushes") - flushes_before;
+    const std::uint64_t bytes = counter_value("log.flushed_bytes") - bytes_before;
+    char extra[256];
+    std::snprintf(extra, sizeof(extra),
+                  "\"threads\":%d,\"low_power\":%s,\"batch\":%zu,\"lines\":%zu,\"flushes\":%llu,"
+                  "\"bytes_per_flush\":%llu,\"rotations\":%llu",
+                  c.threads, c.low_power ? "true" : "false", c.batch ? kBatchSize : 1, total_lines,
+                  static_cast<unsigned long long>(flushes),
+                  static_cast<unsigned long long>(flushes ? bytes / flushes : 0),
+                  static_cast<unsigned long long>(counter_value("log.rotations") - rotations_before));
+
+    // ops are lines, so write_log and batch_write throughput compare directly
+    report.add(id, total_lines, seconds, &all, extra);
+    remove_tree(dir);
+}
+
+} // namespace
+
+void run_logger(const Options& opt, Report& report) {
+    if (!group_selected(opt, "logger")) return;
+    std::printf("Logger:\n");
+
+    const size_t lines = opt.quick ? 40000 : 400000;
+    std::vector<int> thread_counts;
+    for (int t = 1; t <= opt.max_threads; t *= 2) thread_counts.push_back(t);
+
+    // Rotation is not the point here: keep the limit out of the way
+    constexpr size_t kNoRotation = size_t{1} << 40;
+    for (const bool low_power : {false, true}) {
+        for (const int threads : thread_counts) {
+            run_case(opt, report, {"logger.write_log", threads, low_power, false, kNoRotation, lines});
+            run_case(opt, report, {"logger.batch_write", threads, low_power, true, kNoRotation, lines});
+        }
+    }
+
+    // The module's default limit: every ~1200 lines rotate to .old under contention
+    for (const int threads : thread_counts) {
+        run_case(opt, report, {"logger.rotation", threads, false, false, 102400, lines});
+    }
+}
+
+} // namespace bench
@@ -0,0 +1,188 @@
+#include "bench.hpp"
+#include <string>
+#include <fstream>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+
+// Linux-specific headers
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+// End-to-end cost of one `log_info` call from a shell script, through the module's
+// own logger.sh, against a scratch MODPATH:
+//   shell.loop               the same loop calling `:`, run 100x as often so it stands out
+//                            from the setup noise (subtracted to get net_mean_ns)
+//   shell.log_info/logmonitor one logmonitor process per line, logmonitor daemon running
+//   shell.log_info/aurorad   the same writes with aurorad up instead of the logmonitor
+//                            daemon; routing lines through aurorad clients cost ~2x
+namespace bench {
+
+namespace {
+
+// Setup and teardown (init_logger's daemon start, stop_logger's sleep) are the same for
+// any COUNT, so each case runs COUNT=0 and COUNT=N and keeps the difference of the medians
+constexpr int kRepeats = 3;
+constexpr size_t kLoopScale = 100;
+
+const char* const kScript = R"(
+. "$LOGGER_SH"
+set_log_file bench
+init_logger
+i=0
+while [ "$i" -lt "$COUNT" ]; do
+    $CALL "bench message $i from the shell logging path"
+    i=$((i + 1))
+done
+flush_logs
+stop_logger
+)";
+
+bool prepare_modpath(const std::string& root, const Options& opt) {
+    for (const char* sub : {"/bin", "/logs", "/files", "/files/data", "/module_settings"}) {
+        if (mkdir((root + sub).c_str(), 0755) != 0) return false;
+    }
+    std::ofstream(root + "/module_settings/config.sh") << "size=4G\n";
+    return symlink(opt.logmonitor.c_str(), (root + "/bin/logmonitor-zram").c_str()) == 0 &&
+           (opt.aurorad.empty() || symlink(opt.aurorad.c_str(), (root + "/bin/aurorad-zram").c_str()) == 0);
+}
+
+size_t count_lines(const std::string& path) {
+    std::ifstream in(path);
+    size_t lines = 0;
+    for (std::string line; std::getline(in, line);) ++lines;
+    return lines;
+}
+
+// Runs the script on an empty log, returns its wall time in seconds or -1
+double run_script(const std::string& modpath, const Options& opt, const char* call, size_t count) {
+    unlink((modpath + "/logs/bench.log").c_str());
+    const auto start = Clock::now();
+    const pid_t pid = fork();
+    if (pid == 0) {
+        const int null = open("/dev/null", O_WRONLY);
+        dup2(null, STDOUT_FILENO);
+        setenv("MODPATH", modpath.c_str(), 1);
+        setenv("LOGGER_SH", opt.logger_sh.c_str(), 1);
+        setenv("COUNT", std::to_string(count).c_str(), 1);
+        setenv("CALL", call, 1);
+        execl("/bin/sh", "sh", "-c", kScript, static_cast<char*>(nullptr));
+        _exit(127);
+    }
+    if (pid < 0) return -1;
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) return -1;
+    return static_cast<double>(elapsed_ns(start)) / 1e9;
+}
+
+double median_run(const std::string& modpath, const Options& opt, const char* call, size_t count) {
+    double runs[kRepeats];
+    for (double& run : runs) {
+        run = run_script(modpath, opt, call, count);
+        if (run < 0) return -1;
+    }
+    std::sort(runs, runs + kRepeats);
+    return runs[kRepeats / 2];
+}
+
+// Seconds for `count` calls: the N-call runs minus the empty runs. -1 when a run failed,
+// 0 when the calls did not stand out from the run-to-run noise (not measured)
+double measure(const std::string& modpath, const Options& opt, const char* call, size_t count) {
+    const double empty = median_run(modpath, opt, call, 0);
+    const double full = empty < 0 ? -1 : median_run(modpath, opt, call, count);
+    if (empty < 0 || full < 0) return -1;
+    return full > empty ? full - empty : 0;
+}
+
+void shell_case(const Options& opt, Report& report, const char* name, const char* call, size_t count,
+                bool with_aurorad, double loop_ns) {
+    if (!selected(opt, name)) return;
+    const std::string modpath = make_temp_dir(opt, "shell");
+    if (!prepare_modpath(modpath, opt)) {
+        std::fprintf(stderr, "Cannot prepare %s (%s)\n", modpath.c_str(), strerror(errno));
+        remove_tree(modpath);
+        return;
+    }
+
+    pid_t daemon = -1;
+    if (with_aurorad) {
+        daemon = fork();
+        if (daemon == 0) {
+            const int null = open("/dev/null", O_WRONLY);
+            dup2(null, STDOUT_FILENO);
+            execl(opt.aurorad.c_str(), "aurorad", "-m", modpath.c_str(), "-D", "86400", "daemon",
+                  static_cast<char*>(nullptr));
+            _exit(127);
+        }
+        // init_logger pings aurorad only once the socket exists
+        const std::string sock = modpath + "/files/data/aurorad.sock";
+        struct stat st;
+        for (int i = 0; i < 100 && stat(sock.c_str(), &st) != 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    const double seconds = measure(modpath, opt, call, count);
+
+    if (daemon > 0) {
+        kill(daemon, SIGTERM);
+        waitpid(daemon, nullptr, 0);
+    }
+    if (seconds <= 0) {
+        std::fprintf(stderr, "  %s %s\n", name, seconds < 0 ? "failed" : "not measured (below run-to-run noise)");
+        remove_tree(modpath);
+        return;
+    }
+
+    const size_t written = count_lines(modpath + "/logs/bench.log");
+    const double mean_ns = seconds * 1e9 / static_cast<double>(count);
+    char extra[160];
+    int len = std::snprintf(extra, sizeof(extra), "\"calls\":%zu,\"lines_written\":%zu,\"mean_ns\":%.0f", count,
+                            written, mean_ns);
+    if (loop_ns > 0) std::snprintf(extra + len, sizeof(extra) - len, ",\"net_mean_ns\":%.0f", mean_ns - loop_ns);
+    report.add(name, count, seconds, nullptr, extra);
+    remove_tree(modpath);
+}
+
+} // namespace
+
+void run_shell(const Options& opt, Report& report) {
+    if (!group_selected(opt, "shell")) return;
+    if (opt.logger_sh.empty() || opt.logmonitor.empty() || access(opt.logmonitor.c_str(), X_OK) != 0) {
+        std::printf("Shell: skipped (needs --logger-sh and --logmonitor)\n");
+        return;
+    }
+    std::printf("Shell:\n");
+
+    const size_t count = opt.quick ? 100 : 1000;
+    // Baseline: the loop with a no-op instead of log_info, per-call ns or 0 when not measured
+    const size_t loop_count = count * kLoopScale;
+    const std::string modpath = make_temp_dir(opt, "shell");
+    double loop = -1;
+    if (prepare_modpath(modpath, opt)) loop = measure(modpath, opt, ":", loop_count);
+    remove_tree(modpath);
+    const double loop_ns = loop > 0 ? loop * 1e9 / static_cast<double>(loop_count) : 0;
+    if (selected(opt, "shell.loop")) {
+        if (loop > 0) {
+            char extra[64];
+            std::snprintf(extra, sizeof(extra), "\"calls\":%zu,\"mean_ns\":%.0f", loop_count, loop_ns);
+            report.add("shell.loop", loop_count, loop, nullptr, extra);
+        } else {
+            std::fprintf(stderr, "  shell.loop %s\n", loop < 0 ? "failed" : "not measured (below run-to-run noise)");
+        }
+    }
+
+    shell_case(opt, report, "shell.log_info/logmonitor", "log_info", count, false, loop_ns);
+    if (!opt.aurorad.empty() && access(opt.aurorad.c_str(), X_OK) == 0) {
+        shell_case(opt, report, "shell.log_info/aurorad", "log_info", count, true, loop_ns);
+    }
+}
+
+} // namespace bench
@@ -0,0 +1,197 @@
+#include "bench.hpp"
+#include "watcher_core.hpp"
+#include "stats.hpp"
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+// Linux-specific headers
+#include <sys/inotify.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+
+// Event-to-action latency of the watcher under event storms on tmpfs. A generator
+// creates files named e<seq> and stamps the send time of each; the consumer stamps
+// when the action for that file ran:
+//   watcher.callback  in-process WatcherCore callback (how aurorad hosts watches)
+//   watcher.command   the filewatcher binary running a shell command per event
+namespace bench {
+
+namespace {
+
+std::uint64_t counter_value(const char* name) {
+    for (const auto& [key, value] : stats::Registry::instance().snapshot().counters) {
+        if (key == name) return value;
+    }
+    return 0;
+}
+
+// Returns the path's sequence number, or -1 when it is not a generated file
+long sequence_of(std::string_view path) {
+    const auto slash = path.rfind('/');
+    const std::string_view name = slash == std::string_view::npos ? path : path.substr(slash + 1);
+    if (name.size() < 2 || name[0] != 'e') return -1;
+    return std::strtol(std::string{name.substr(1)}.c_str(), nullptr, 10);
+}
+
+// Creates `count` files in `dir`, `gap_us` apart (0 = as fast as possible)
+void generate(const std::string& dir, size_t first, size_t count, int gap_us, std::vector<Clock::time_point>& sent) {
+    char path[512];
+    for (size_t i = first; i < first + count; ++i) {
+        std::snprintf(path, sizeof(path), "%s/e%zu", dir.c_str(), i);
+        sent[i] = Clock::now();
+        const int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd >= 0) close(fd);
+        if (gap_us > 0) std::this_thread::sleep_for(std::chrono::microseconds(gap_us));
+    }
+}
+
+struct Storm {
+    const char* name;
+    size_t events;
+    int gap_us;
+};
+
+void callback_case(const Options& opt, Report& report, const Storm& storm) {
+    const std::string id = std::string("watcher.callback/") + storm.name;
+    if (!selected(opt, id)) return;
+    const std::string dir = make_temp_dir(opt, "watch");
+    std::vector<Clock::time_point> sent(storm.events);
+    Latencies lat;
+    lat.reserve(storm.events);
+    size_t received = 0;
+    const std::uint64_t overflows_before = counter_value("watch.queue_overflows");
+    const std::uint64_t reads_before = counter_value("watch.reads");
+
+    WatcherCore watcher;
+    watcher.add_watch(dir, [&](const std::string& path) {
+        const long seq = sequence_of(path);
+        if (seq < 0 || static_cast<size_t>(seq) >= sent.size()) return;
+        lat.add(elapsed_ns(sent[static_cast<size_t>(seq)]));
+        ++received;
+    }, IN_CLOSE_WRITE);
+
+    std::atomic<bool> done{false};
+    const auto start = Clock::now();
+    std::thread generator([&] {
+        generate(dir, 0, storm.events, storm.gap_us, sent);
+        done.store(true);
+    });
+
+    // Drain until every event arrived, or 2s of silence after the generator finished
+    pollfd pfd{watcher.fd(), POLLIN, 0};
+    auto last_event = Clock::now();
+    while (received < storm.events) {
+        if (poll(&pfd, 1, 100) > 0) {
+            watcher.dispatch();
+            last_event = Clock::now();
+        } else if (done.load() && Clock::now() - last_event > std::chrono::seconds(2)) {
+            break;
+        }
+    }
+    const double seconds = static_cast<double>(elapsed_ns(start)) / 1e9;
+    generator.join();
+
+    char extra[192];
+    std::snprintf(extra, sizeof(extra), "\"events\":%zu,\"received\":%zu,\"reads\":%llu,\"queue_overflows\":%llu",
+                  storm.events, received,
+                  static_cast<unsigned long long>(counter_value("watch.reads") - reads_before),
+                  static_cast<unsigned long long>(counter_value("watch.queue_overflows") - overflows_before));
+    report.add(id, received, seconds, &lat, extra);
+    remove_tree(dir);
+}
+
+// The filewatcher binary with stdout on a pipe and "echo $FILE" as the action: each
+// line we read back is one completed command, fork and shell included
+void command_case(const Options& opt, Report& report, const Storm& storm) {
+    const std::string id = std::string("watcher.command/") + storm.name;
+    if (!selected(opt, id)) return;
+    const std::string dir = make_temp_dir(opt, "fw");
+    int out[2];
+    if (pipe2(out, O_CLOEXEC) != 0) return;
+
+    const pid_t pid = fork();
+    if (pid == 0) {
+        dup2(out[1], STDOUT_FILENO);
+        execl(opt.filewatcher.c_str(), "filewatcher", "-e", "create", dir.c_str(), "echo $FILE",
+              static_cast<char*>(nullptr));
+        _exit(127);
+    }
+    close(out[1]);
+    if (pid < 0) {
+        close(out[0]);
+        return;
+    }
+    // No readiness signal from filewatcher (its banner is block-buffered on a pipe)
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    std::vector<Clock::time_point> sent(storm.events);
+    Latencies lat;
+    size_t received = 0;
+    const auto start = Clock::now();
+    std::thread generator(generate, std::cref(dir), size_t{0}, storm.events, storm.gap_us, std::ref(sent));
+
+    std::string pending;
+    char buf[4096];
+    pollfd pfd{out[0], POLLIN, 0};
+    while (received < storm.events && poll(&pfd, 1, 5000) > 0) {
+        const ssize_t n = read(out[0], buf, sizeof(buf));
+        if (n <= 0) break;
+        const auto now = Clock::now();
+        pending.append(buf, static_cast<size_t>(n));
+        for (size_t nl; (nl = pending.find('\n')) != std::string::npos; pending.erase(0, nl + 1)) {
+            const long seq = sequence_of(std::string_view{pending}.substr(0, nl));
+            if (seq < 0 || static_cast<size_t>(seq) >= sent.size()) continue;
+            lat.add(elapsed_ns(sent[static_cast<size_t>(seq)], now));
+            ++received;
+        }
+    }
+    const double seconds = static_cast<double>(elapsed_ns(start)) / 1e9;
+    generator.join();
+
+    kill(pid, SIGTERM);
+    waitpid(pid, nullptr, 0);
+    close(out[0]);
+
+    char extra[96];
+    std::snprintf(extra, sizeof(extra), "\"events\":%zu,\"received\":%zu", storm.events, received);
+    report.add(id, received, seconds, &lat, extra);
+    remove_tree(dir);
+}
+
+} // namespace
+
+void run_watcher(const Options& opt, Report& report) {
+    if (!group_selected(opt, "watcher")) return;
+    std::printf("Watcher:\n");
+
+    // isolated: one event at a time, the idle wakeup path
+    // burst/storm: back-to-back creates, queueing and batching in read()
+    const Storm callback_storms[] = {
+        {"isolated", opt.quick ? 50u : 500u, 2000},
+        {"burst", opt.quick ? 1000u : 10000u, 0},
+        {"storm", opt.quick ? 10000u : 100000u, 0},
+    };
+    for (const auto& storm : callback_storms) callback_case(opt, report, storm);
+
+    if (!selected(opt, "watcher.command")) return;
+    if (opt.filewatcher.empty() || access(opt.filewatcher.c_str(), X_OK) != 0) {
+        std::printf("  watcher.command skipped (no --filewatcher)\n");
+        return;
+    }
+    const Storm command_storms[] = {
+        {"isolated", opt.quick ? 20u : 100u, 20000},
+        {"burst", opt.quick ? 100u : 500u, 0},
+    };
+    for (const auto& storm : command_storms) command_case(opt, report, storm);
+}
+
+} // namespace bench
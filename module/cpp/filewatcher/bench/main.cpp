@@ -0,0 +1,288 @@
+#include "bench.hpp"
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+
+// Linux-specific headers
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#include <sys/utsname.h>
+#include <ftw.h>
+#include <unistd.h>
+
+namespace bench {
+
+namespace {
+
+constexpr long kTmpfsMagic = 0x01021994;
+
+std::string json_escape(std::string_view text) {
+    std::string out;
+    for (const char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20) out += c;
+    }
+    return out;
+}
+
+// Value of a numeric member on a report line, NaN-free: -1 when missing
+double field(const std::string& line, const char* key) {
+    const std::string needle = std::string("\"") + key + "\":";
+    const auto pos = line.find(needle);
+    return pos == std::string::npos ? -1 : std::atof(line.c_str() + pos + needle.size());
+}
+
+std::string id_of(const std::string& line) {
+    const auto pos = line.find("\"id\":\"");
+    if (pos == std::string::npos) return {};
+    const auto start = pos + 6;
+    return line.substr(start, line.find('"', start) - start);
+}
+
+} // namespace
+
+void Report::add(std::string id, std::uint64_t ops, double seconds, Latencies* latencies, std::string extra) {
+    Row row{std::move(id), ops, seconds, seconds > 0 ? static_cast<double>(ops) / seconds : 0, false, 0, 0, 0, 0, 0,
+            std::move(extra)};
+    if (latencies && latencies->size() > 0) {
+        latencies->finish();
+        row.has_latency = true;
+        row.p50 = latencies->percentile(0.5);
+        row.p90 = latencies->percentile(0.9);
+        row.p99 = latencies->percentile(0.99);
+        row.p999 = latencies->percentile(0.999);
+        row.max = latencies->percentile(1.0);
+    }
+    if (row.has_latency) {
+        std::printf("  %-44s %12.0f ops/s  p50 %8llu ns  p99 %10llu ns\n", row.id.c_str(), row.ops_per_s,
+                    static_cast<unsigned long long>(row.p50), static_cast<unsigned long long>(row.p99));
+    } else {
+        std::printf("  %-44s %12.0f ops/s  (no per-call samples)\n", row.id.c_str(), row.ops_per_s);
+    }
+    std::fflush(stdout);
+    rows_.push_back(std::move(row));
+}
+
+// One result per line so the report stays diffable and easy to grep
+bool Report::write(const std::string& path, const Options& opt) const {
+    FILE* fp = std::fopen(path.c_str(), "we");
+    if (!fp) return false;
+
+    utsname uts{};
+    uname(&uts);
+    char date[32];
+    const std::time_t now = std::time(nullptr);
+    std::tm tm;
+    gmtime_r(&now, &tm);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", &tm);
+
+    std::fprintf(fp, "{\"version\":1,\"date\":\"%s\",\"host\":{\"kernel\":\"%s %s\",\"machine\":\"%s\",\"cpus\":%u,"
+                     "\"compiler\":\"%s\",\"tmp\":\"%s\",\"tmpfs\":%s},\"quick\":%s,\"results\":[\n",
+                 date, uts.sysname, uts.release, uts.machine, std::thread::hardware_concurrency(),
+                 json_escape(__VERSION__).c_str(), json_escape(opt.tmp_base).c_str(),
+                 is_tmpfs(opt.tmp_base) ? "true" : "false", opt.quick ? "true" : "false");
+    for (size_t i = 0; i < rows_.size(); ++i) {
+        const Row& r = rows_[i];
+        std::fprintf(fp, "{\"id\":\"%s\",\"ops\":%llu,\"seconds\":%.6f,\"ops_per_s\":%.1f",
+                     json_escape(r.id).c_str(), static_cast<unsigned long long>(r.ops), r.seconds, r.ops_per_s);
+        if (r.has_latency) {
+            std::fprintf(fp, ",\"p50_ns\":%llu,\"p90_ns\":%llu,\"p99_ns\":%llu,\"p999_ns\":%llu,\"max_ns\":%llu",
+                         static_cast<unsigned long long>(r.p50), static_cast<unsigned long long>(r.p90),
+                         static_cast<unsigned long long>(r.p99), static_cast<unsigned long long>(r.p999),
+                         static_cast<unsigned long long>(r.max));
+        }
+        std::fprintf(fp, "%s%s}%s\n", r.extra.empty() ? "" : ",", r.extra.c_str(), i + 1 < rows_.size() ? "," : "");
+    }
+    std::fprintf(fp, "]}\n");
+    return std::fclose(fp) == 0;
+}
+
+// -q runs far fewer iterations; its throughput and tail latencies are not comparable to a full run
+bool Report::comparable(const std::string& baseline_path, const Options& opt) {
+    std::ifstream in(baseline_path);
+    std::string header;
+    if (!in || !std::getline(in, header)) {
+        std::fprintf(stderr, "Cannot open baseline: %s (%s)\n", baseline_path.c_str(), strerror(errno));
+        return false;
+    }
+    const bool baseline_quick = header.find("\"quick\":true") != std::string::npos;
+    if (baseline_quick != opt.quick) {
+        std::fprintf(stderr, "Baseline %s is a %s run, this is a %s run; not comparing\n", baseline_path.c_str(),
+                     baseline_quick ? "quick (-q)" : "full", opt.quick ? "quick (-q)" : "full");
+        return false;
+    }
+    return true;
+}
+
+int Report::compare(const std::string& baseline_path, const Options& opt, double throughput_drop, double latency_rise) const {
+    std::ifstream in(baseline_path);
+    if (!in) {
+        std::fprintf(stderr, "Cannot open baseline: %s (%s)\n", baseline_path.c_str(), strerror(errno));
+        return -1;
+    }
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);) {
+        if (line.starts_with("{\"id\":")) lines.push_back(std::move(line));
+    }
+
+    int regressions = 0;
+    std::printf("\nAgainst %s (regression: throughput -%.0f%% or p99 +%.0f%%):\n", baseline_path.c_str(),
+                throughput_drop * 100, latency_rise * 100);
+    for (const Row& r : rows_) {
+        const auto it = std::find_if(lines.begin(), lines.end(), [&](const std::string& l) { return id_of(l) == r.id; });
+        if (it == lines.end()) {
+            std::printf("  %-44s new\n", r.id.c_str());
+            continue;
+        }
+        const double base_ops = field(*it, "ops_per_s");
+        const double base_p99 = field(*it, "p99_ns");
+        const double ops_delta = base_ops > 0 ? (r.ops_per_s - base_ops) / base_ops : 0;
+        // Rows without per-call samples (and older baselines that wrote 0 for them) have no p99
+        const bool has_p99 = r.has_latency && base_p99 > 0;
+        const double p99_delta = has_p99 ? (static_cast<double>(r.p99) - base_p99) / base_p99 : 0;
+        const bool regressed = ops_delta < -throughput_drop || p99_delta > latency_rise;
+        regressions += regressed;
+        char p99_text[16] = "   n/a";
+        if (has_p99) std::snprintf(p99_text, sizeof(p99_text), "%+6.1f%%", p99_delta * 100);
+        std::printf("  %-44s ops/s %+6.1f%%  p99 %s%s\n", r.id.c_str(), ops_delta * 100, p99_text,
+                    regressed ? "  REGRESSION" : "");
+    }
+    // A case that silently stopped running (missing binary, renamed id) must not pass as "no regression"
+    for (const std::string& line : lines) {
+        const std::string id = id_of(line);
+        if (!selected(opt, id)) continue;
+        if (std::none_of(rows_.begin(), rows_.end(), [&](const Row& r) { return r.id == id; })) {
+            std::printf("  %-44s MISSING\n", id.c_str());
+            ++regressions;
+        }
+    }
+    return regressions;
+}
+
+bool selected(const Options& opt, std::string_view id) {
+    if (opt.only.empty()) return true;
+    return std::any_of(opt.only.begin(), opt.only.end(), [&](const std::string& p) { return id.starts_with(p); });
+}
+
+// True when some case of the group can match: "-c log" and "-c logger.write" both select "logger"
+bool group_selected(const Options& opt, std::string_view group) {
+    if (opt.only.empty()) return true;
+    return std::any_of(opt.only.begin(), opt.only.end(), [&](const std::string& p) {
+        return group.starts_with(p) || std::string_view{p}.starts_with(group);
+    });
+}
+
+bool is_tmpfs(const std::string& path) {
+    struct statfs fs{};
+    return statfs(path.c_str(), &fs) == 0 && static_cast<long>(fs.f_type) == kTmpfsMagic;
+}
+
+std::string make_temp_dir(const Options& opt, const char* tag) {
+    std::string tmpl = opt.tmp_base + "/aurora_bench_" + tag + "_XXXXXX";
+    if (!mkdtemp(tmpl.data())) {
+        std::fprintf(stderr, "mkdtemp failed in %s (%s)\n", opt.tmp_base.c_str(), strerror(errno));
+        std::exit(1);
+    }
+    return tmpl;
+}
+
+void remove_tree(const std::string& path) {
+    nftw(path.c_str(), [](const char* p, const struct stat*, int, FTW*) { return remove(p); }, 16, FTW_DEPTH | FTW_PHYS);
+}
+
+} // namespace bench
+
+static void print_usage(const char* prog) noexcept {
+    std::printf("Usage: %s [options]\n", prog);
+    std::printf("Options:\n");
+    std::printf("  -o FILE           Write the JSON report (default: bench_report.json)\n");
+    std::printf("  -b FILE           Compare against a previous report of the same -q mode; exit 2 on\n");
+    std::printf("                    regressions or baseline cases that did not run\n");
+    std::printf("  -r DROP:RISE      Regression thresholds in %% (default: 20:50)\n");
+    std::printf("  -q                Quick run (fewer iterations)\n");
+    std::printf("  -t N              Maximum producer threads (default: 8)\n");
+    std::printf("  -c PREFIX         Only run cases whose id starts with PREFIX (repeatable), e.g. logger,\n");
+    std::printf("                    logger.write_log/t4, watcher.command, footprint.logmonitor/lean\n");
+    std::printf("  -T DIR            Scratch directory (default: /dev/shm, else /tmp)\n");
+    std::printf("  --logmonitor BIN  Shipped (lean) logmonitor for the shell and footprint cases\n");
+    std::printf("  --logmonitor-full BIN  Threaded logmonitor build, footprint comparison only\n");
+    std::printf("  --filewatcher BIN filewatcher binary for the command latency cases\n");
+    std::printf("  --aurorad BIN     aurorad binary for the shell cases\n");
+    std::printf("  --logger-sh FILE  logger.sh to source for the shell cases\n");
+    std::printf("  -h                Show help\n");
+}
+
+int main(int argc, char* argv[]) {
+    bench::Options opt;
+    std::string output = "bench_report.json";
+    std::string baseline;
+    double drop = 20, rise = 50;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        if (arg == "-o" && i + 1 < argc) output = argv[++i];
+        else if (arg == "-b" && i + 1 < argc) baseline = argv[++i];
+        else if (arg == "-r" && i + 1 < argc) {
+            if (std::sscanf(argv[++i], "%lf:%lf", &drop, &rise) != 2 || drop <= 0 || rise <= 0) {
+                std::fprintf(stderr, "Invalid thresholds: %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (arg == "-q") opt.quick = true;
+        else if (arg == "-t" && i + 1 < argc) opt.max_threads = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "-c" && i + 1 < argc) opt.only.emplace_back(argv[++i]);
+        else if (arg == "-T" && i + 1 < argc) opt.tmp_base = argv[++i];
+        else if (arg == "--logmonitor" && i + 1 < argc) opt.logmonitor = argv[++i];
+        else if (arg == "--logmonitor-full" && i + 1 < argc) opt.logmonitor_full = argv[++i];
+        else if (arg == "--filewatcher" && i + 1 < argc) opt.filewatcher = argv[++i];
+        else if (arg == "--aurorad" && i + 1 < argc) opt.aurorad = argv[++i];
+        else if (arg == "--logger-sh" && i + 1 < argc) opt.logger_sh = argv[++i];
+        else if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            std::fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (opt.tmp_base.empty()) opt.tmp_base = bench::is_tmpfs("/dev/shm") ? "/dev/shm" : "/tmp";
+    // The shell cases symlink and exec these from a scratch directory
+    for (std::string* path : {&opt.logmonitor, &opt.logmonitor_full, &opt.filewatcher, &opt.aurorad, &opt.logger_sh}) {
+        if (path->empty()) continue;
+        if (char* resolved = realpath(path->c_str(), nullptr)) {
+            *path = resolved;
+            std::free(resolved);
+        }
+    }
+
+    // Checked before the run, not after minutes of benchmarking
+    if (!baseline.empty() && !bench::Report::comparable(baseline, opt)) return 1;
+
+    bench::Report report;
+    std::printf("Scratch: %s%s\n", opt.tmp_base.c_str(), bench::is_tmpfs(opt.tmp_base) ? " (tmpfs)" : "");
+    bench::run_logger(opt, report);
+    bench::run_watcher(opt, report);
+    bench::run_shell(opt, report);
+    bench::run_footprint(opt, report);
+
+    if (!report.write(output, opt)) {
+        std::fprintf(stderr, "Cannot write: %s (%s)\n", output.c_str(), strerror(errno));
+        return 1;
+    }
+    std::printf("Report: %s\n", output.c_str());
+
+    int regressions = 0;
+    if (!baseline.empty()) {
+        regressions = report.compare(baseline, opt, drop / 100, rise / 100);
+        if (regressions < 0) return 1;
+    }
+    for (const auto& failure : report.failures()) std::printf("OVER BUDGET: %s\n", failure.c_str());
+    if (!report.failures().empty()) return 3;
+    return regressions > 0 ? 2 : 0;
+}
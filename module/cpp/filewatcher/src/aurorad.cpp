@@ -0,0 +1,710 @@
+#include "watcher_core.hpp"
+#include "logger.hpp"
+#include "governor.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <deque>
+#include <array>
+#include <chrono>
+#include <optional>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <cstddef>
+
+// Linux-specific headers
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+
+// aurorad: one process and one epoll loop for what used to be four resident processes
+// (logmonitor daemon, filewatcher in enter_pause_mode, the service_script loop and the
+// zram_pressure_log.sh sampler), plus the optional PSI governor. Shell scripts talk to it
+// through a unix socket; the same binary is the client ("aurorad status", "aurorad log ...").
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kMaxRequest = 4096;
+constexpr size_t kMaxClients = 16;
+constexpr size_t kPressureHistory = 100;   // lines kept in memory_zram_pressure.log
+constexpr int kPressureAverageEvery = 5;   // samples between average_pressure.conf updates
+
+enum Source : std::uint32_t {
+    kSignal,
+    kControl,
+    kWatch,
+    kSampleTimer,
+    kGovernorTimer,
+    kPsiTrigger,
+    kFlushTimer,
+    kReloadTimer,
+    kClient,
+};
+
+struct Options {
+    std::string moddir{"/data/adb/modules/zram"};
+    std::string socket_path;
+    LogLevel log_level{LogLevel::INFO};
+    bool low_power{false};
+    int sample_delay_s{300};
+    int sample_interval_s{60};
+};
+
+// KEY=VALUE lines of config.sh; quotes and trailing comments stripped
+std::map<std::string, std::string> read_config(const std::string& path) {
+    std::map<std::string, std::string> config;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        const auto eq = line.find('=');
+        if (eq == std::string::npos || line[0] == '#' || line.find_first_of(" \t") < eq) continue;
+        std::string value = line.substr(eq + 1);
+        if (!value.empty() && (value[0] == '"' || value[0] == '\'')) {
+            const auto close = value.find(value[0], 1);
+            value = value.substr(1, close == std::string::npos ? std::string::npos : close - 1);
+        } else {
+            value = value.substr(0, value.find_first_of(" \t#"));
+        }
+        config[line.substr(0, eq)] = value;
+    }
+    return config;
+}
+
+int config_int(const std::map<std::string, std::string>& config, const char* key, int fallback) {
+    const auto it = config.find(key);
+    return it == config.end() || it->second.empty() ? fallback : std::atoi(it->second.c_str());
+}
+
+double config_double(const std::map<std::string, std::string>& config, const char* key, double fallback) {
+    const auto it = config.find(key);
+    return it == config.end() || it->second.empty() ? fallback : std::atof(it->second.c_str());
+}
+
+bool arm_timer(int fd, int first_ms, int interval_ms) noexcept {
+    itimerspec spec{};
+    spec.it_value.tv_sec = first_ms / 1000;
+    spec.it_value.tv_nsec = (first_ms % 1000) * 1000000L;
+    spec.it_interval.tv_sec = interval_ms / 1000;
+    spec.it_interval.tv_nsec = (interval_ms % 1000) * 1000000L;
+    return timerfd_settime(fd, 0, &spec, nullptr) == 0;
+}
+
+void drain(int fd) noexcept {
+    std::uint64_t expirations;
+    while (read(fd, &expirations, sizeof(expirations)) > 0) {}
+}
+
+bool write_file_atomic(const std::string& path, std::string_view content) noexcept {
+    const std::string tmp = path + ".tmp";
+    const int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    const bool ok = write(fd, content.data(), content.size()) == static_cast<ssize_t>(content.size());
+    close(fd);
+    return ok && rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+sockaddr_un socket_address(const std::string& path, socklen_t& len) noexcept {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    len = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + std::strlen(addr.sun_path) + 1);
+    return addr;
+}
+
+// A control connection: the request is read and the reply written without blocking the loop
+struct Client {
+    std::string request;
+    std::string reply;
+    size_t sent{0};
+    bool replying{false};
+};
+
+// Memory used % and zram0 fill %, the same numbers zram_pressure_log.sh recorded
+struct PressureSampler {
+    std::string log_path;
+    std::string average_path;
+    std::deque<std::pair<int, int>> history;
+    int since_average{0};
+
+    void load() {
+        std::ifstream in(log_path);
+        int mem = 0, zram = 0;
+        char sep;
+        while (in >> mem >> sep >> zram) {
+            history.emplace_back(mem, zram);
+            if (history.size() > kPressureHistory) history.pop_front();
+        }
+    }
+
+    bool sample(std::string& line) {
+        governor::Sample s;
+        governor::Governor::read_meminfo(s);
+        zram::MmStat mm;
+        std::string disksize;
+        if (!zram::read_mm_stat("zram0", mm) || !zram::read_sysfs(zram::sysfs_path("zram0", "disksize"), disksize)) {
+            return false;
+        }
+        const unsigned long long size = std::strtoull(disksize.c_str(), nullptr, 10);
+        const int fill = size > 0 ? static_cast<int>(std::min(100ULL, mm.orig_data_size * 100 / size)) : 0;
+
+        history.emplace_back(s.mem_used_pct, fill);
+        if (history.size() > kPressureHistory) history.pop_front();
+        line = std::to_string(s.mem_used_pct) + ":" + std::to_string(fill);
+
+        std::string content;
+        for (const auto& [mem, zram] : history) {
+            content += std::to_string(mem) + ":" + std::to_string(zram) + "\n";
+        }
+        write_file_atomic(log_path, content);
+
+        if (++since_average >= kPressureAverageEvery) {
+            since_average = 0;
+            long mem_sum = 0, zram_sum = 0;
+            for (const auto& [mem, zram] : history) {
+                mem_sum += mem;
+                zram_sum += zram;
+            }
+            const auto count = static_cast<long>(history.size());
+            write_file_atomic(average_path, std::to_string(mem_sum / count) + ":" + std::to_string(zram_sum / count) + "\n");
+        }
+        return true;
+    }
+};
+
+class Supervisor {
+public:
+    explicit Supervisor(Options opt)
+        : opt_(std::move(opt))
+        , logger_(opt_.moddir + "/logs", opt_.log_level, 102400, false) {
+        if (opt_.low_power) logger_.set_low_power_mode(true);
+        sampler_.log_path = opt_.moddir + "/files/data/memory_zram_pressure.log";
+        sampler_.average_path = opt_.moddir + "/files/data/average_pressure.conf";
+    }
+
+    ~Supervisor() {
+        for (const int fd : {epoll_fd_, signal_fd_, listen_fd_, sample_timer_, governor_timer_, flush_timer_, reload_timer_, psi_trigger_}) {
+            if (fd >= 0) close(fd);
+        }
+        if (listen_fd_ >= 0) unlink(opt_.socket_path.c_str());
+        for (const auto& [fd, client] : clients_) close(fd);
+    }
+
+    bool init() {
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd_ < 0) return fail("epoll_create1");
+
+        sigset_t mask;
+        sigemptyset(&mask);
+        sigaddset(&mask, SIGTERM);
+        sigaddset(&mask, SIGINT);
+        sigaddset(&mask, SIGCHLD);
+        sigprocmask(SIG_BLOCK, &mask, &saved_mask_);
+        signal_fd_ = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+        if (signal_fd_ < 0 || !add(signal_fd_, kSignal, EPOLLIN)) return fail("signalfd");
+
+        if (!listen_control()) return false;
+
+        // Watch the directory, editors and the WebUI replace config.sh by rename
+        const std::string settings = opt_.moddir + "/module_settings";
+        if (!watcher_.add_watch(settings, [this](const std::string& path) { on_settings_changed(path); },
+                                IN_CLOSE_WRITE | IN_MOVED_TO) ||
+            !add(watcher_.fd(), kWatch, EPOLLIN)) {
+            return fail(("watch " + settings).c_str());
+        }
+
+        for (auto [fd, source] : {std::pair{&sample_timer_, kSampleTimer}, {&governor_timer_, kGovernorTimer},
+                                  {&flush_timer_, kFlushTimer}, {&reload_timer_, kReloadTimer}}) {
+            *fd = timerfd_create(CLOCK_BOOTTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+            if (*fd < 0 || !add(*fd, source, EPOLLIN)) return fail("timerfd_create");
+        }
+
+        sampler_.load();
+        apply_config(true);
+        log(LogLevel::INFO, "aurorad started (pid " + std::to_string(getpid()) + ")");
+        return true;
+    }
+
+    int run() {
+        std::array<epoll_event, 8> events{};
+        while (running_) {
+            const int n = epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), -1);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return fail("epoll_wait") ? 0 : 1;
+            }
+            ++wakeups_;
+            for (int i = 0; i < n; ++i) {
+                const auto& ev = events[static_cast<size_t>(i)];
+                const auto source = static_cast<Source>(ev.data.u64 & 0xffffffffu);
+                stats::add(wakeup_ids_[source]);
+                handle(source, ev.events, static_cast<int>(ev.data.u64 >> 32));
+            }
+        }
+
+        if (governor_) governor_->restore();
+        log(LogLevel::INFO, "aurorad stopping");
+        logger_.flush_all();
+        logger_.stop();
+        return 0;
+    }
+
+private:
+    Options opt_;
+    Logger logger_;
+    WatcherCore watcher_;
+    PressureSampler sampler_;
+    std::optional<governor::Governor> governor_;
+    std::map<int, Client> clients_;
+    int epoll_fd_{-1}, signal_fd_{-1}, listen_fd_{-1};
+    int sample_timer_{-1}, governor_timer_{-1}, flush_timer_{-1}, reload_timer_{-1}, psi_trigger_{-1};
+    sigset_t saved_mask_{};
+    bool running_{true};
+    bool flush_armed_{false};
+    bool sampler_enabled_{false};
+    pid_t reload_pid_{-1};
+    bool reload_pending_{false};
+    unsigned long long wakeups_{0};
+    // Wakeups by source, to check that debouncing and flush batching actually pay off
+    std::array<stats::Id, kClient + 1> wakeup_ids_{
+        stats::counter("aurorad.wakeups.signal"), stats::counter("aurorad.wakeups.control"),
+        stats::counter("aurorad.wakeups.watch"), stats::counter("aurorad.wakeups.sample"),
+        stats::counter("aurorad.wakeups.governor"), stats::counter("aurorad.wakeups.psi"),
+        stats::counter("aurorad.wakeups.flush"), stats::counter("aurorad.wakeups.reload"),
+        stats::counter("aurorad.wakeups.client")};
+    stats::Id request_us_{stats::histogram("aurorad.request_us")};
+    unsigned reloads_{0};
+    std::string last_sample_;
+    const Clock::time_point started_{Clock::now()};
+
+    bool fail(const char* what) {
+        std::fprintf(stderr, "%s failed (%s)\n", what, strerror(errno));
+        return false;
+    }
+
+    // The source goes in the low half of the event data; client events carry their fd in the high half
+    bool add(int fd, Source source, std::uint32_t events, int op = EPOLL_CTL_ADD) noexcept {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.u64 = (source == kClient ? static_cast<std::uint64_t>(fd) << 32 : 0) | source;
+        return epoll_ctl(epoll_fd_, op, fd, &ev) == 0;
+    }
+
+    void log(LogLevel level, std::string_view message, std::string_view name = "aurorad") {
+        logger_.write_log(name, level, message);
+        arm_flush(level);
+    }
+
+    // One-shot flush instead of the logger's periodic thread: no wakeups while idle, and
+    // none for lines the level filter dropped (DEBUG sampler lines at the default level)
+    void arm_flush(LogLevel level) noexcept {
+        if (level > opt_.log_level || flush_armed_) return;
+        flush_armed_ = arm_timer(flush_timer_, opt_.low_power ? 60000 : 15000, 0);
+    }
+
+    bool listen_control() {
+        unlink(opt_.socket_path.c_str());
+        listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        socklen_t len;
+        const sockaddr_un addr = socket_address(opt_.socket_path, len);
+        if (listen_fd_ < 0 || bind(listen_fd_, reinterpret_cast<const sockaddr*>(&addr), len) != 0 ||
+            listen(listen_fd_, 8) != 0 || !add(listen_fd_, kControl, EPOLLIN)) {
+            return fail(("listen " + opt_.socket_path).c_str());
+        }
+        chmod(opt_.socket_path.c_str(), 0600);
+        return true;
+    }
+
+    void handle(Source source, std::uint32_t events, int fd) {
+        switch (source) {
+            case kSignal: on_signal(); break;
+            case kControl: on_accept(); break;
+            case kClient: on_client(fd); break;
+            case kWatch: watcher_.dispatch(); break;
+            case kSampleTimer:
+                drain(sample_timer_);
+                if (sampler_.sample(last_sample_)) log(LogLevel::DEBUG, "pressure sample " + last_sample_);
+                break;
+            case kGovernorTimer:
+                drain(governor_timer_);
+                governor_tick(false);
+                break;
+            case kPsiTrigger:
+                if (events & EPOLLERR) {
+                    log(LogLevel::WARN, "PSI trigger closed by the kernel, falling back to interval sampling", "governor");
+                    close(psi_trigger_);
+                    psi_trigger_ = -1;
+                    break;
+                }
+                governor_tick(true);
+                break;
+            case kFlushTimer:
+                drain(flush_timer_);
+                flush_armed_ = false;
+                logger_.flush_all();
+                break;
+            case kReloadTimer:
+                drain(reload_timer_);
+                start_reload();
+                break;
+        }
+    }
+
+    void on_signal() {
+        signalfd_siginfo info;
+        while (read(signal_fd_, &info, sizeof(info)) == sizeof(info)) {
+            if (info.ssi_signo != SIGCHLD) {
+                running_ = false;
+                continue;
+            }
+            int status = 0;
+            pid_t pid;
+            while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+                if (pid == reload_pid_) finish_reload(status);
+            }
+        }
+    }
+
+    void on_settings_changed(const std::string& path) {
+        if (!path.ends_with("/config.sh")) return;
+        // Debounce: a save is often several writes/renames in a row
+        arm_timer(reload_timer_, 1000, 0);
+    }
+
+    // zram_reload.sh runs zram_reconfigure with the module's shell environment
+    void start_reload() {
+        if (reload_pid_ > 0) {
+            reload_pending_ = true;
+            return;
+        }
+        log(LogLevel::INFO, "config changed, reconfiguring zram");
+        // Hand the knobs back before the script runs: restoring afterwards would undo the
+        // zstd level it just applied
+        stop_governor();
+        const std::string script = opt_.moddir + "/files/scripts/zram_reload.sh";
+        const pid_t pid = fork();
+        if (pid == 0) {
+            sigprocmask(SIG_SETMASK, &saved_mask_, nullptr);
+            execlp("sh", "sh", script.c_str(), opt_.moddir.c_str(), static_cast<char*>(nullptr));
+            _exit(127);
+        }
+        if (pid < 0) {
+            log(LogLevel::ERROR, std::string("fork failed: ") + strerror(errno));
+            apply_config(false);
+            return;
+        }
+        reload_pid_ = pid;
+        ++reloads_;
+    }
+
+    void finish_reload(int status) {
+        reload_pid_ = -1;
+        const int code = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+        log(code == 0 ? LogLevel::INFO : LogLevel::ERROR, "zram reconfigure finished with status " + std::to_string(code));
+        if (reload_pending_) {
+            // The governor stays stopped until the last queued reload is done
+            reload_pending_ = false;
+            start_reload();
+            return;
+        }
+        // A fresh governor captures the values zram_reconfigure just wrote as its originals
+        apply_config(false);
+    }
+
+    // Writes back the values the governor captured at start and disarms its wakeups
+    void stop_governor() {
+        if (governor_) {
+            governor_->restore();
+            governor_.reset();
+        }
+        if (psi_trigger_ >= 0) {
+            close(psi_trigger_);
+            psi_trigger_ = -1;
+        }
+        arm_timer(governor_timer_, 0, 0);
+    }
+
+    void apply_config(bool initial) {
+        const auto config = read_config(opt_.moddir + "/module_settings/config.sh");
+
+        // The sampler only feeds size=auto, as zram_pressure_log.sh did
+        const bool sampler = config.count("size") && config.at("size") == "auto";
+        if (sampler != sampler_enabled_) {
+            sampler_enabled_ = sampler;
+            arm_timer(sample_timer_, sampler ? (initial ? opt_.sample_delay_s : opt_.sample_interval_s) * 1000 : 0,
+                      sampler ? opt_.sample_interval_s * 1000 : 0);
+            log(LogLevel::INFO, sampler ? "pressure sampler enabled" : "pressure sampler disabled");
+        }
+
+        stop_governor();
+        if (config.count("governor_enabled") && config.at("governor_enabled") == "true") {
+            governor::Config gc;
+            gc.swappiness = {config_int(config, "governor_swappiness_min", 60), config_int(config, "governor_swappiness_max", 100)};
+            gc.watermark = {config_int(config, "governor_watermark_min", 10), config_int(config, "governor_watermark_max", 100)};
+            gc.zstd_level = {config_int(config, "governor_zstd_level_min", 1), config_int(config, "governor_zstd_level_max", 9)};
+            gc.psi_low = config_double(config, "governor_psi_low", 1.0);
+            gc.psi_high = config_double(config, "governor_psi_high", 10.0);
+            const int interval = std::max(1, config_int(config, "governor_interval", 10));
+
+            governor_.emplace(gc);
+            arm_timer(governor_timer_, interval * 1000, interval * 1000);
+            psi_trigger_ = governor::open_psi_trigger(150000, 1000000);
+            if (psi_trigger_ >= 0) add(psi_trigger_, kPsiTrigger, EPOLLPRI);
+            log(LogLevel::INFO, psi_trigger_ >= 0 ? "Governor started (PSI trigger armed)" : "Governor started (interval only)",
+                "governor");
+        }
+    }
+
+    void governor_tick(bool event) {
+        if (!governor_) return;
+        governor::Sample s;
+        s.event = event;
+        if (governor_->sample(s)) {
+            governor_->tick(s, [this](int level, const char* message) {
+                log(static_cast<LogLevel>(level), message, "governor");
+            });
+        }
+    }
+
+    // Requests are NUL-separated argv ended by the client's shutdown(SHUT_WR); the reply is
+    // text and the connection is closed
+    void on_accept() {
+        for (;;) {
+            const int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) return;
+            if (clients_.size() >= kMaxClients || !add(fd, kClient, EPOLLIN)) {
+                log(LogLevel::WARN, "too many control connections, dropping one");
+                close(fd);
+                continue;
+            }
+            clients_.emplace(fd, Client{});
+        }
+    }
+
+    void on_client(int fd) {
+        const auto it = clients_.find(fd);
+        if (it == clients_.end()) return;
+        Client& client = it->second;
+        if (client.replying) {
+            send_reply(fd, client);
+            return;
+        }
+
+        char buf[1024];
+        for (;;) {
+            const ssize_t len = read(fd, buf, sizeof(buf));
+            if (len > 0) {
+                client.request.append(buf, static_cast<size_t>(len));
+                if (client.request.size() >= kMaxRequest) break;
+                continue;
+            }
+            if (len < 0 && errno == EINTR) continue;
+            if (len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;  // rest of the request later
+            if (len < 0) {
+                drop_client(fd);
+                return;
+            }
+            break;  // EOF: the request is complete
+        }
+
+        std::vector<std::string_view> args;
+        const std::string_view request{client.request};
+        for (size_t pos = 0; pos < request.size();) {
+            const size_t end = std::min(request.find('\0', pos), request.size());
+            args.push_back(request.substr(pos, end - pos));
+            pos = end + 1;
+        }
+        {
+            const stats::Timer timer(request_us_);
+            client.reply = args.empty() ? "error: empty request\n" : command(args);
+        }
+        client.replying = true;
+        send_reply(fd, client);
+    }
+
+    // Writes what the socket takes now and waits for EPOLLOUT for the rest
+    void send_reply(int fd, Client& client) {
+        while (client.sent < client.reply.size()) {
+            const ssize_t len = write(fd, client.reply.data() + client.sent, client.reply.size() - client.sent);
+            if (len > 0) {
+                client.sent += static_cast<size_t>(len);
+                continue;
+            }
+            if (len < 0 && errno == EINTR) continue;
+            if (len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                add(fd, kClient, EPOLLOUT, EPOLL_CTL_MOD);
+                return;
+            }
+            log(LogLevel::WARN, std::string("control reply failed: ") + strerror(errno));
+            break;
+        }
+        drop_client(fd);
+    }
+
+    void drop_client(int fd) {
+        clients_.erase(fd);
+        close(fd);
+    }
+
+    std::string command(const std::vector<std::string_view>& args) {
+        const auto cmd = args[0];
+        if (cmd == "log" && args.size() == 4) {
+            const int level = std::atoi(std::string{args[2]}.c_str());
+            if (level < 1 || level > 4) return "error: invalid level\n";
+            logger_.write_log(args[1], static_cast<LogLevel>(level), args[3]);
+            arm_flush(static_cast<LogLevel>(level));
+            return "";
+        }
+        if (cmd == "ping") return "pong\n";
+        if (cmd == "flush") {
+            logger_.flush_all();
+            return "ok\n";
+        }
+        if (cmd == "reload") {
+            start_reload();
+            return "ok\n";
+        }
+        if (cmd == "stop") {
+            running_ = false;
+            return "ok\n";
+        }
+        if (cmd == "status") return status();
+        if (cmd == "stats") return stats::snapshot_json();
+        return "error: unknown command\n";
+    }
+
+    std::string status() {
+        std::string rss = "0";
+        if (std::ifstream in("/proc/self/status"); in) {
+            std::string line;
+            while (std::getline(in, line)) {
+                if (line.starts_with("VmRSS:")) {
+                    rss = std::to_string(std::atol(line.c_str() + 6));
+                    break;
+                }
+            }
+        }
+        const auto uptime = std::chrono::duration_cast<std::chrono::seconds>(Clock::now() - started_).count();
+
+        char buf[512];
+        std::snprintf(buf, sizeof(buf),
+                      "{\"pid\":%d,\"uptime_s\":%lld,\"wakeups\":%llu,\"rss_kb\":%s,"
+                      "\"sampler\":{\"enabled\":%s,\"samples\":%zu,\"last\":\"%s\"},"
+                      "\"governor\":{\"enabled\":%s,\"mode\":\"%s\"},"
+                      "\"reloads\":%u,\"reload_running\":%s}\n",
+                      getpid(), static_cast<long long>(uptime), wakeups_, rss.c_str(),
+                      sampler_enabled_ ? "true" : "false", sampler_.history.size(), last_sample_.c_str(),
+                      governor_ ? "true" : "false", governor_ ? governor::mode_name(governor_->mode()) : "OFF",
+                      reloads_, reload_pid_ > 0 ? "true" : "false");
+        return buf;
+    }
+};
+
+int run_client(const Options& opt, int argc, char* argv[], int first) {
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    socklen_t len;
+    const sockaddr_un addr = socket_address(opt.socket_path, len);
+    if (fd < 0 || connect(fd, reinterpret_cast<const sockaddr*>(&addr), len) != 0) {
+        std::fprintf(stderr, "Cannot connect: %s (%s)\n", opt.socket_path.c_str(), strerror(errno));
+        if (fd >= 0) close(fd);
+        return 1;
+    }
+
+    std::string request;
+    for (int i = first; i < argc; ++i) {
+        if (i > first) request += '\0';
+        request += argv[i];
+    }
+    const bool sent = write(fd, request.data(), request.size()) == static_cast<ssize_t>(request.size());
+    shutdown(fd, SHUT_WR);
+
+    std::string reply;
+    char buf[1024];
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0) reply.append(buf, static_cast<size_t>(n));
+    close(fd);
+
+    std::fputs(reply.c_str(), stdout);
+    return sent && !reply.starts_with("error") ? 0 : 1;
+}
+
+void print_usage(const char* prog) noexcept {
+    std::printf("Usage: %s [options] <command> [args]\n", prog);
+    std::printf("Commands:\n");
+    std::printf("  daemon                 Run the supervisor\n");
+    std::printf("  ping                   Check that the supervisor answers\n");
+    std::printf("  status                 Print supervisor state as JSON\n");
+    std::printf("  stats                  Print logger/watcher/loop counters and histograms as JSON\n");
+    std::printf("  log NAME LEVEL MSG     Write MSG to logs/NAME.log (LEVEL 1-4)\n");
+    std::printf("  flush                  Flush buffered logs\n");
+    std::printf("  reload                 Re-run zram_reconfigure now\n");
+    std::printf("  stop                   Stop the supervisor\n");
+    std::printf("Options:\n");
+    std::printf("  -m DIR     Module directory (default: /data/adb/modules/zram)\n");
+    std::printf("  -s PATH    Control socket (default: DIR/files/data/aurorad.sock)\n");
+    std::printf("  -l LEVEL   Log level for daemon (1=Error .. 4=Debug, default: 3)\n");
+    std::printf("  -p         Low power mode (longer log flush delay)\n");
+    std::printf("  -D SEC     Delay before the first pressure sample (default: 300)\n");
+    std::printf("  -h         Show help\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    int i = 1;
+    for (; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        if (arg == "-m" && i + 1 < argc) opt.moddir = argv[++i];
+        else if (arg == "-s" && i + 1 < argc) opt.socket_path = argv[++i];
+        else if (arg == "-l" && i + 1 < argc) {
+            const int level = std::atoi(argv[++i]);
+            if (level < 1 || level > 4) {
+                std::fprintf(stderr, "Invalid log level: %s\n", argv[i]);
+                return 1;
+            }
+            opt.log_level = static_cast<LogLevel>(level);
+        }
+        else if (arg == "-p") opt.low_power = true;
+        else if (arg == "-D" && i + 1 < argc) opt.sample_delay_s = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            break;
+        }
+    }
+    if (opt.socket_path.empty()) opt.socket_path = opt.moddir + "/files/data/aurorad.sock";
+
+    if (i >= argc) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (std::string_view{argv[i]} != "daemon") {
+        return run_client(opt, argc, argv, i);
+    }
+
+    umask(0022);
+    signal(SIGPIPE, SIG_IGN);
+    try {
+        Supervisor supervisor(opt);
+        if (!supervisor.init()) return 1;
+        return supervisor.run();
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "aurorad: %s\n", e.what());
+        return 1;
+    }
+}
@@ -7,7 +7,6 @@
 #include <string_view>
 #include <memory>
 #include <atomic>
-#include <format>
 
 static std::unique_ptr<WatcherCore> g_watcher;
 
@@ -25,6 +24,7 @@ void print_usage(std::string_view prog_name) noexcept {
     std::printf("               Available: modify,create,delete,move,attrib,access\n");
     std::printf("  -p <seconds> Enable periodic check every N seconds (0 to disable)\n");
     std::printf("  -o           One-shot mode: exit after first event detection\n");
+    std::printf("  -S <file>    Write event/command counters as JSON to file (every 10s while active, and on exit)\n");
     std::printf("  -h           Show this help\n");
     std::printf("\nExamples:\n");
     std::printf("  %s /tmp/test.txt \"echo File changed: $FILE\"\n", prog_name.data());
@@ -64,6 +64,7 @@ int main(int argc, char* argv[]) {
     std::uint32_t events = IN_MODIFY | IN_CREATE | IN_DELETE;
     int periodic_interval = 0;
     bool one_shot = false;
+    std::string_view stats_file;
     
     for (int i = 1; i < argc; i++) {
         const std::string_view arg{argv[i]};
@@ -77,6 +78,8 @@ int main(int argc, char* argv[]) {
             }
         } else if (arg == "-o") {
             one_shot = true;
+        } else if (arg == "-S" && i + 1 < argc) {
+            stats_file = argv[++i];
         } else if (arg == "-h") {
             print_usage(argv[0]);
             return 0;
@@ -103,6 +106,9 @@ int main(int argc, char* argv[]) {
     if (one_shot) {
         g_watcher->set_one_shot(true);
     }
+    if (!stats_file.empty()) {
+        g_watcher->set_stats_file(std::string{stats_file});
+    }
     
     if (!g_watcher->add_watch(path, command, events)) {
         std::fprintf(stderr, "Failed to add watch for: %s\n", path.data());
@@ -1,16 +1,24 @@
 #include "watcher_core.hpp"
 #include <sys/inotify.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
 #include <unistd.h>
 #include <poll.h>
+#include <fcntl.h>
 #include <cstring>
 #include <cstdlib>
 #include <cstdio>
-#include <format>
 #include <string_view>
 #include <algorithm>
+#include <array>
 #include <thread>
 
+// Written by a command's child process, well under PIPE_BUF so writes never interleave
+struct CommandReport {
+    std::uint64_t runtime_us;
+    int exit_code;
+};
+
 WatcherCore::WatcherCore() noexcept {
     inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
 #ifdef ANDROID_DOZE_AWARE
@@ -23,6 +31,11 @@ WatcherCore::~WatcherCore() noexcept {
     if (inotify_fd_ >= 0) {
         close(inotify_fd_);
     }
+    for (const int fd : report_pipe_) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
 #ifdef ANDROID_DOZE_AWARE
     if (wake_fd_ != -1) {
         close(wake_fd_);
@@ -40,7 +53,23 @@ bool WatcherCore::add_watch(std::string_view path, std::string_view command, std
         return false;
     }
     
-    watches_.emplace(wd, WatchInfo{std::string{path}, std::string{command}, events});
+    auto [it, inserted] = watches_.emplace(wd, WatchInfo{std::string{path}, std::string{command}, events});
+    it->second.events_id = stats::counter("watch.events." + it->second.path);
+    return true;
+}
+
+bool WatcherCore::add_watch(std::string_view path, WatchCallback callback, std::uint32_t events) noexcept {
+    if (inotify_fd_ < 0) {
+        return false;
+    }
+    
+    const int wd = inotify_add_watch(inotify_fd_, std::string{path}.c_str(), events);
+    if (wd < 0) {
+        return false;
+    }
+    
+    auto [it, inserted] = watches_.insert_or_assign(wd, WatchInfo{std::string{path}, std::move(callback), events});
+    it->second.events_id = stats::counter("watch.events." + it->second.path);
     return true;
 }
 
@@ -58,11 +87,17 @@ void WatcherCore::start() noexcept {
     
     while (running_.load(std::memory_order_relaxed)) {
         const int poll_result = poll(&pfd, 1, timeout_ms);
+        stats::add(counters_.wakeups);
+        if (!children_.empty()) {
+            reap_children();
+        }
         
         if (poll_result > 0 && (pfd.revents & POLLIN)) {
             const ssize_t len = read(inotify_fd_, buffer.data(), buffer.size());
             if (len > 0) {
+                stats::add(counters_.reads);
                 process_events(std::string_view{buffer.data(), static_cast<size_t>(len)});
+                write_stats(false);
                 
                 if (one_shot_.load(std::memory_order_relaxed)) {
                     break;
@@ -76,20 +111,46 @@ void WatcherCore::start() noexcept {
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
     }
+    write_stats(true);
 }
 
 void WatcherCore::stop() noexcept {
     running_.store(false, std::memory_order_relaxed);
 }
 
+void WatcherCore::dispatch() noexcept {
+    alignas(struct inotify_event) std::array<char, 4096> buffer{};
+    ssize_t len;
+    while ((len = read(inotify_fd_, buffer.data(), buffer.size())) > 0) {
+        stats::add(counters_.reads);
+        process_events(std::string_view{buffer.data(), static_cast<size_t>(len)});
+    }
+}
+
 void WatcherCore::process_events(std::string_view buffer) noexcept {
+    const stats::Timer timer(counters_.batch_us);
     size_t offset = 0;
     
     while (offset < buffer.size()) {
         const auto* event = reinterpret_cast<const struct inotify_event*>(buffer.data() + offset);
+        stats::add(counters_.events);
+        if (event->mask & IN_Q_OVERFLOW) {
+            stats::add(counters_.overflows);
+        }
         
         if (const auto it = watches_.find(event->wd); it != watches_.end()) {
-            execute_command(it->second.command, it->second.path, event);
+            stats::add(it->second.events_id);
+            if (it->second.callback) {
+                stats::add(counters_.callbacks);
+                std::string filename = it->second.path;
+                if (event->len > 0) {
+                    filename += "/";
+                    filename += event->name;
+                }
+                it->second.callback(filename);
+            } else {
+                execute_command(it->second.command, it->second.path, event);
+            }
         }
         
         offset += sizeof(struct inotify_event) + event->len;
@@ -109,9 +170,51 @@ void WatcherCore::execute_command(std::string_view command, const std::string& p
         cmd.replace(pos, 5, filename);
     }
     
+    stats::add(counters_.commands);
+    if (report_pipe_[0] < 0 && pipe2(report_pipe_, O_CLOEXEC | O_NONBLOCK) != 0) {
+        report_pipe_[0] = report_pipe_[1] = -1;
+    }
+    
     if (const pid_t pid = fork(); pid == 0) {
-        std::system(cmd.c_str());
-        std::exit(0);
+        // The child times the command itself so the runtime does not depend on when we reap
+        const auto start = std::chrono::steady_clock::now();
+        const int status = std::system(cmd.c_str());
+        const CommandReport report{
+            static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count()),
+            WIFEXITED(status) ? WEXITSTATUS(status) : 1};
+        if (report_pipe_[1] >= 0) {
+            (void)!write(report_pipe_[1], &report, sizeof(report));
+        }
+        std::_Exit(report.exit_code);
+    } else if (pid > 0) {
+        children_.push_back(pid);
+    } else {
+        stats::add(counters_.command_failures);
+    }
+}
+
+void WatcherCore::reap_children() noexcept {
+    CommandReport report;
+    while (report_pipe_[0] >= 0 && read(report_pipe_[0], &report, sizeof(report)) == sizeof(report)) {
+        stats::record(counters_.command_us, report.runtime_us);
+        if (report.exit_code != 0) {
+            stats::add(counters_.command_failures);
+        }
+    }
+    std::erase_if(children_, [](const pid_t pid) {
+        return waitpid(pid, nullptr, WNOHANG) == pid;
+    });
+}
+
+void WatcherCore::write_stats(bool force) noexcept {
+    if (stats_file_.empty()) {
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (force || now - stats_written_ >= std::chrono::seconds(10)) {
+        stats::write_json(stats_file_);
+        stats_written_ = now;
     }
 }
 
@@ -126,7 +229,12 @@ void WatcherCore::set_one_shot(bool enabled) noexcept {
 void WatcherCore::periodic_check() noexcept {
     for (auto& [wd, watch_info] : watches_) {
         if (file_changed(watch_info.path, watch_info.last_check)) {
-            execute_command(watch_info.command, watch_info.path, nullptr);
+            stats::add(counters_.periodic);
+            if (watch_info.callback) {
+                watch_info.callback(watch_info.path);
+            } else {
+                execute_command(watch_info.command, watch_info.path, nullptr);
+            }
         }
     }
 }
@@ -1,4 +1,5 @@
 #pragma once
+#include "stats.hpp"
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -6,6 +7,8 @@
 #include <chrono>
 #include <atomic>
 #include <memory>
+#include <functional>
+#include <vector>
 #include <sys/stat.h>
 #ifdef ANDROID_DOZE_AWARE
 #include <sys/eventfd.h>
@@ -14,16 +17,24 @@
 
 struct inotify_event;
 
+// In-process handler used instead of a shell command; receives the changed path
+using WatchCallback = std::function<void(const std::string& path)>;
+
 struct WatchInfo {
     std::string path;
     std::string command;
+    WatchCallback callback;
     std::uint32_t events;
     std::chrono::steady_clock::time_point last_check;
+    stats::Id events_id{stats::kInvalid};
     
     WatchInfo() = default;
     WatchInfo(std::string p, std::string cmd, std::uint32_t ev) noexcept
         : path(std::move(p)), command(std::move(cmd)), events(ev), 
           last_check(std::chrono::steady_clock::now()) {}
+    WatchInfo(std::string p, WatchCallback cb, std::uint32_t ev) noexcept
+        : path(std::move(p)), callback(std::move(cb)), events(ev),
+          last_check(std::chrono::steady_clock::now()) {}
 };
 
 class WatcherCore final {
@@ -37,12 +48,19 @@ public:
     WatcherCore& operator=(WatcherCore&&) = delete;
     
     bool add_watch(std::string_view path, std::string_view command, std::uint32_t events) noexcept;
+    bool add_watch(std::string_view path, WatchCallback callback, std::uint32_t events) noexcept;
     
     void start() noexcept;
     void stop() noexcept;
     
+    // For hosting the watcher in another event loop: poll fd() for POLLIN, then dispatch()
+    int fd() const noexcept { return inotify_fd_; }
+    void dispatch() noexcept;
+    
     void set_periodic_check(int interval_seconds) noexcept;
     void set_one_shot(bool enabled) noexcept;
+    // Snapshot stats.hpp counters as JSON here, at most every 10s while events arrive and on exit
+    void set_stats_file(std::string path) noexcept { stats_file_ = std::move(path); }
     
 private:
     void process_events(std::string_view buffer) noexcept;
@@ -50,6 +68,8 @@ private:
                         const struct inotify_event* event) noexcept;
     void periodic_check() noexcept;
     bool file_changed(const std::string& path, std::chrono::steady_clock::time_point& last_check) noexcept;
+    void reap_children() noexcept;
+    void write_stats(bool force) noexcept;
     
 #ifdef ANDROID_DOZE_AWARE
     void setup_doze_protection() noexcept;
@@ -61,4 +81,22 @@ private:
     std::atomic<bool> one_shot_{false};
     std::atomic<int> periodic_interval_{0};
     std::unordered_map<int, WatchInfo> watches_;
+    // Spawned commands not yet reaped; each reports its runtime and status through report_pipe_
+    std::vector<pid_t> children_;
+    int report_pipe_[2] = {-1, -1};
+    std::string stats_file_;
+    std::chrono::steady_clock::time_point stats_written_{};
+
+    struct Counters {
+        stats::Id wakeups = stats::counter("watch.wakeups");
+        stats::Id reads = stats::counter("watch.reads");
+        stats::Id events = stats::counter("watch.events");
+        stats::Id overflows = stats::counter("watch.queue_overflows");
+        stats::Id callbacks = stats::counter("watch.callbacks");
+        stats::Id periodic = stats::counter("watch.periodic_triggers");
+        stats::Id commands = stats::counter("watch.commands");
+        stats::Id command_failures = stats::counter("watch.command_failures");
+        stats::Id command_us = stats::histogram("watch.command_us");
+        stats::Id batch_us = stats::histogram("watch.process_events_us");
+    } counters_;
 };
\ No newline at end of file
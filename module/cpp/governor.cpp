@@ -0,0 +1,164 @@
+#include "governor.hpp"
+#include <string>
+#include <string_view>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+
+// Linux-specific headers
+#include <sys/stat.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+struct Options {
+    governor::Config config;
+    std::string log_dir{"/data/adb/modules/zram/logs"};
+    int interval_s{10};
+    bool once{false};
+};
+
+static volatile sig_atomic_t g_stop = 0;
+
+static void signal_handler(int) {
+    g_stop = 1;
+}
+
+// Same line format and .old rotation as logmonitor; decisions are rare, so append directly
+static void write_log(const std::string& dir, int level, const char* message) noexcept {
+    static const char* const kLevels[] = {"UNKNOWN", "ERROR", "WARN", "INFO", "DEBUG"};
+    const std::string path = dir + "/governor.log";
+
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0 && st.st_size > 102400) {
+        rename(path.c_str(), (path + ".old").c_str());
+    }
+
+    char line[512];
+    const std::time_t now = std::time(nullptr);
+    std::tm tm;
+    localtime_r(&now, &tm);
+    size_t len = std::strftime(line, sizeof(line), "%Y-%m-%d %H:%M:%S", &tm);
+    len += static_cast<size_t>(std::snprintf(line + len, sizeof(line) - len, " [%s] %s\n",
+                                             kLevels[level >= 1 && level <= 4 ? level : 0], message));
+    len = std::min(len, sizeof(line) - 1);
+
+    const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) return;
+    if (write(fd, line, len) < 0) {
+        std::fprintf(stderr, "Failed to write: %s (%s)\n", path.c_str(), strerror(errno));
+    }
+    close(fd);
+}
+
+static bool parse_bounds(const char* text, governor::Bounds& out) noexcept {
+    int min = 0, max = 0;
+    if (std::sscanf(text, "%d:%d", &min, &max) != 2 || min < 0 || min > max) return false;
+    out = {min, max};
+    return true;
+}
+
+static void print_usage(const char* prog) noexcept {
+    std::printf("Usage: %s [options]\n", prog);
+    std::printf("Options:\n");
+    std::printf("  -i SEC       Sampling interval (default: 10)\n");
+    std::printf("  -s MIN:MAX   vm.swappiness bounds (default: 60:100)\n");
+    std::printf("  -w MIN:MAX   vm.watermark_scale_factor bounds (default: 10:100)\n");
+    std::printf("  -z MIN:MAX   zstd compression level bounds (default: 1:9)\n");
+    std::printf("  -P MIN:MAX   Memory component bounds for the zram pressure attribute (default: 0:100)\n");
+    std::printf("  -L LOW:HIGH  PSI some avg10 thresholds in %% (default: 1:10)\n");
+    std::printf("  -H TICKS     Calm ticks before stepping down a mode (default: 3)\n");
+    std::printf("  -D DEV       zram device for fill, ratio and pressure (default: zram0)\n");
+    std::printf("  -d DIR       Log directory (default: /data/adb/modules/zram/logs)\n");
+    std::printf("  -n           Dry run: log decisions without writing\n");
+    std::printf("  -1           Sample once, print the decisions without writing and exit\n");
+    std::printf("  -h           Show help\n");
+}
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    auto& cfg = opt.config;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        bool ok = true;
+        if (arg == "-i" && i + 1 < argc) opt.interval_s = std::atoi(argv[++i]);
+        else if (arg == "-s" && i + 1 < argc) ok = parse_bounds(argv[++i], cfg.swappiness);
+        else if (arg == "-w" && i + 1 < argc) ok = parse_bounds(argv[++i], cfg.watermark);
+        else if (arg == "-z" && i + 1 < argc) ok = parse_bounds(argv[++i], cfg.zstd_level);
+        else if (arg == "-P" && i + 1 < argc) ok = parse_bounds(argv[++i], cfg.pressure);
+        else if (arg == "-L" && i + 1 < argc) {
+            ok = std::sscanf(argv[++i], "%lf:%lf", &cfg.psi_low, &cfg.psi_high) == 2 && cfg.psi_low < cfg.psi_high;
+        }
+        else if (arg == "-H" && i + 1 < argc) cfg.hold_ticks = std::atoi(argv[++i]);
+        else if (arg == "-D" && i + 1 < argc) cfg.device = argv[++i];
+        else if (arg == "-d" && i + 1 < argc) opt.log_dir = argv[++i];
+        else if (arg == "-n") cfg.dry_run = true;
+        else if (arg == "-1") opt.once = true;
+        else if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            std::fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            return 1;
+        }
+        if (!ok) {
+            std::fprintf(stderr, "Invalid value for %s: %s\n", argv[i - 1], argv[i]);
+            return 1;
+        }
+    }
+    if (opt.interval_s <= 0 || cfg.hold_ticks <= 0) {
+        std::fprintf(stderr, "Invalid option value\n");
+        return 1;
+    }
+
+    // A one-shot run never reaches restore(), so it only reports what it would change
+    if (opt.once) cfg.dry_run = true;
+
+    governor::Governor gov(cfg);
+    governor::Sample sample;
+    if (!gov.sample(sample)) {
+        std::fprintf(stderr, "Cannot read %s (%s), PSI is required\n", governor::kPsiMemoryPath, strerror(errno));
+        return 1;
+    }
+
+    if (opt.once) {
+        gov.tick(sample, [](int, const char* message) { std::printf("%s\n", message); });
+        std::printf("mode %s\n", governor::mode_name(gov.mode()));
+        return 0;
+    }
+
+    umask(0022);
+    signal(SIGTERM, signal_handler);
+    signal(SIGINT, signal_handler);
+    const auto log = [&](int level, const char* message) { write_log(opt.log_dir, level, message); };
+
+    // 150 ms of stalls within 1 s wakes the loop early; without triggers it only polls
+    int trigger = governor::open_psi_trigger(150000, 1000000);
+    log(3, trigger >= 0 ? "Governor started (PSI trigger armed)" : "Governor started (interval only)");
+
+    while (!g_stop) {
+        pollfd pfd{trigger, POLLPRI, 0};
+        const int ready = poll(&pfd, trigger >= 0 ? 1 : 0, opt.interval_s * 1000);
+        if (ready < 0 && errno != EINTR) break;
+        if (g_stop) break;
+        if (ready > 0 && (pfd.revents & POLLERR)) {
+            log(2, "PSI trigger closed by the kernel, falling back to interval sampling");
+            close(trigger);
+            trigger = -1;
+        }
+
+        governor::Sample s;
+        s.event = ready > 0 && (pfd.revents & POLLPRI);
+        if (gov.sample(s)) gov.tick(s, log);
+    }
+
+    if (trigger >= 0) close(trigger);
+    gov.restore();
+    log(3, "Governor stopped, original values restored");
+    return 0;
+}
@@ -0,0 +1,268 @@
+#pragma once
+#include "zram_sysfs.hpp"
+#include <string>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Linux-specific headers
+#include <fcntl.h>
+#include <unistd.h>
+
+// PSI-driven tuning of the reclaim/compression knobs. Each tick reads PSI memory
+// averages, meminfo and zram mm_stat, moves between three modes with hysteresis and
+// writes only the knobs whose target changed:
+//   RELAXED  light load: densest zstd level, lowest watermark_scale_factor
+//   NORMAL   midpoints
+//   BURST    PSI over the high mark or a PSI trigger fired: cheapest zstd level,
+//            highest watermark_scale_factor so kswapd starts before direct reclaim
+// swappiness follows zram fill in every mode: swapping into a nearly full zram thrashes.
+namespace governor {
+
+struct Bounds {
+    int min;
+    int max;
+
+    int mid() const noexcept { return min + (max - min) / 2; }
+    int clamp(int value) const noexcept { return std::clamp(value, min, max); }
+};
+
+struct Config {
+    Bounds swappiness{60, 100};
+    Bounds watermark{10, 100};
+    Bounds zstd_level{1, 9};
+    Bounds pressure{0, 100};
+    double psi_low{1.0};        // some avg10 (%) below which the load counts as light
+    double psi_high{10.0};      // some avg10 (%) at or above which the load counts as a burst
+    int hold_ticks{3};          // calm ticks required before stepping down a mode
+    std::string device{"zram0"};
+    bool dry_run{false};
+};
+
+struct Sample {
+    double some_avg10{0};
+    double some_avg60{0};
+    double full_avg10{0};
+    int mem_used_pct{0};
+    int zram_fill_pct{0};
+    double ratio{0};
+    bool event{false};          // PSI trigger fired since the last tick
+};
+
+enum class Mode { RELAXED, NORMAL, BURST };
+
+inline const char* mode_name(Mode mode) noexcept {
+    switch (mode) {
+        case Mode::RELAXED: return "RELAXED";
+        case Mode::NORMAL:  return "NORMAL";
+        case Mode::BURST:   return "BURST";
+    }
+    return "UNKNOWN";
+}
+
+constexpr const char* kSwappinessPath = "/proc/sys/vm/swappiness";
+constexpr const char* kWatermarkPath = "/proc/sys/vm/watermark_scale_factor";
+constexpr const char* kZstdLevelPath = "/sys/module/zstd/parameters/compression_level";
+constexpr const char* kPsiMemoryPath = "/proc/pressure/memory";
+
+// One tunable: the value written last, and the value found at startup for restore()
+struct Knob {
+    std::string path;
+    int applied{-1};
+    std::string original;
+    bool available{false};
+
+    void probe() {
+        available = access(path.c_str(), W_OK) == 0 && zram::read_sysfs(path, original);
+        if (available) applied = std::atoi(original.c_str());
+    }
+};
+
+class Governor {
+public:
+    explicit Governor(Config cfg) : cfg_(std::move(cfg)) {
+        swappiness_.path = kSwappinessPath;
+        watermark_.path = kWatermarkPath;
+        zstd_level_.path = kZstdLevelPath;
+        pressure_path_ = zram::sysfs_path(cfg_.device, "pressure");
+        swappiness_.probe();
+        watermark_.probe();
+        zstd_level_.probe();
+        has_pressure_ = access(pressure_path_.c_str(), W_OK) == 0;
+    }
+
+    Mode mode() const noexcept { return mode_; }
+    const Config& config() const noexcept { return cfg_; }
+
+    bool sample(Sample& out) const noexcept {
+        if (!read_psi(out)) return false;
+        read_meminfo(out);
+
+        zram::MmStat mm;
+        std::string disksize;
+        if (zram::read_mm_stat(cfg_.device, mm) && zram::read_sysfs(zram::sysfs_path(cfg_.device, "disksize"), disksize)) {
+            const unsigned long long size = std::strtoull(disksize.c_str(), nullptr, 10);
+            out.zram_fill_pct = size > 0 ? static_cast<int>(std::min(100ULL, mm.orig_data_size * 100 / size)) : 0;
+            out.ratio = mm.compr_data_size > 0 ? static_cast<double>(mm.orig_data_size) / mm.compr_data_size : 0;
+        }
+        return true;
+    }
+
+    // Decide and apply; `log(level, message)` receives every mode change and knob write
+    template <typename Log>
+    void tick(const Sample& s, Log&& log) {
+        const Mode previous = mode_;
+        update_mode(s);
+
+        char reason[160];
+        std::snprintf(reason, sizeof(reason), "some10=%.2f some60=%.2f full10=%.2f mem=%d%% zram=%d%% ratio=%.2f%s",
+                      s.some_avg10, s.some_avg60, s.full_avg10, s.mem_used_pct, s.zram_fill_pct, s.ratio,
+                      s.event ? " event" : "");
+        if (mode_ != previous) {
+            char line[256];
+            std::snprintf(line, sizeof(line), "mode %s -> %s (%s)", mode_name(previous), mode_name(mode_), reason);
+            log(3, line);
+        }
+
+        const int zstd = mode_ == Mode::RELAXED ? cfg_.zstd_level.max
+                       : mode_ == Mode::BURST   ? cfg_.zstd_level.min
+                                                : cfg_.zstd_level.mid();
+        const int watermark = mode_ == Mode::RELAXED ? cfg_.watermark.min
+                            : mode_ == Mode::BURST   ? cfg_.watermark.max
+                                                     : cfg_.watermark.mid();
+        // Full swappiness up to 50% fill, down to the minimum at 95%
+        const int fill = std::clamp(s.zram_fill_pct, 50, 95);
+        const int swappiness = cfg_.swappiness.max - (cfg_.swappiness.max - cfg_.swappiness.min) * (fill - 50) / 45;
+
+        // Mode changes move the discrete knobs at once, swappiness only on a 5 point swing
+        apply(zstd_level_, cfg_.zstd_level.clamp(zstd), 0, "zstd_level", reason, log);
+        apply(watermark_, cfg_.watermark.clamp(watermark), 0, "watermark_scale_factor", reason, log);
+        apply(swappiness_, cfg_.swappiness.clamp(swappiness), 5, "swappiness", reason, log);
+
+        if (has_pressure_) {
+            const int mem = cfg_.pressure.clamp(s.mem_used_pct);
+            if (std::abs(mem - pressure_mem_) >= 5 || std::abs(s.zram_fill_pct - pressure_zram_) >= 5) {
+                const std::string value = std::to_string(mem) + ":" + std::to_string(s.zram_fill_pct);
+                if (cfg_.dry_run || zram::write_sysfs(pressure_path_, value)) {
+                    char line[256];
+                    std::snprintf(line, sizeof(line), "pressure -> %s (%s)", value.c_str(), reason);
+                    log(3, line);
+                    pressure_mem_ = mem;
+                    pressure_zram_ = s.zram_fill_pct;
+                }
+            }
+        }
+    }
+
+    // Put back the values found at startup
+    void restore() noexcept {
+        if (cfg_.dry_run) return;
+        for (Knob* knob : {&swappiness_, &watermark_, &zstd_level_}) {
+            if (knob->available) zram::write_sysfs(knob->path, knob->original);
+        }
+    }
+
+    // MemTotal - MemAvailable as a percentage
+    static void read_meminfo(Sample& out) noexcept {
+        FILE* fp = std::fopen("/proc/meminfo", "re");
+        if (!fp) return;
+        char line[128];
+        long total = 0, available = 0;
+        while (std::fgets(line, sizeof(line), fp) && (total == 0 || available == 0)) {
+            std::sscanf(line, "MemTotal: %ld", &total);
+            std::sscanf(line, "MemAvailable: %ld", &available);
+        }
+        std::fclose(fp);
+        if (total > 0) out.mem_used_pct = static_cast<int>((total - available) * 100 / total);
+    }
+
+private:
+    Config cfg_;
+    Mode mode_{Mode::NORMAL};
+    int calm_ticks_{0};
+    Knob swappiness_, watermark_, zstd_level_;
+    std::string pressure_path_;
+    bool has_pressure_{false};
+    int pressure_mem_{-100};
+    int pressure_zram_{-100};
+
+    // Bursts are entered at once; stepping down needs hold_ticks calm samples in a row,
+    // and each exit threshold sits below its entry threshold
+    void update_mode(const Sample& s) noexcept {
+        const double load = std::max(s.some_avg10, s.full_avg10 * 2);
+        if (s.event || load >= cfg_.psi_high) {
+            mode_ = Mode::BURST;
+            calm_ticks_ = 0;
+            return;
+        }
+        switch (mode_) {
+            case Mode::BURST:
+                calm_ticks_ = load < cfg_.psi_high / 2 ? calm_ticks_ + 1 : 0;
+                if (calm_ticks_ >= cfg_.hold_ticks) {
+                    mode_ = Mode::NORMAL;
+                    calm_ticks_ = 0;
+                }
+                break;
+            case Mode::NORMAL:
+                calm_ticks_ = load < cfg_.psi_low && s.some_avg60 < cfg_.psi_low ? calm_ticks_ + 1 : 0;
+                if (calm_ticks_ >= cfg_.hold_ticks) {
+                    mode_ = Mode::RELAXED;
+                    calm_ticks_ = 0;
+                }
+                break;
+            case Mode::RELAXED:
+                if (load >= cfg_.psi_low * 2) mode_ = Mode::NORMAL;
+                break;
+        }
+    }
+
+    template <typename Log>
+    void apply(Knob& knob, int target, int min_step, const char* name, const char* reason, Log&& log) {
+        if (!knob.available || target == knob.applied) return;
+        if (knob.applied >= 0 && std::abs(target - knob.applied) < min_step) return;
+
+        char line[256];
+        if (!cfg_.dry_run && !zram::write_sysfs(knob.path, std::to_string(target))) {
+            std::snprintf(line, sizeof(line), "Cannot set %s to %d (%s)", name, target, strerror(errno));
+            log(2, line);
+            knob.available = false;
+            return;
+        }
+        std::snprintf(line, sizeof(line), "%s %d -> %d (%s)", name, knob.applied, target, reason);
+        log(3, line);
+        knob.applied = target;
+    }
+
+    static bool read_psi(Sample& out) noexcept {
+        FILE* fp = std::fopen(kPsiMemoryPath, "re");
+        if (!fp) return false;
+        char line[256];
+        while (std::fgets(line, sizeof(line), fp)) {
+            double avg10 = 0, avg60 = 0;
+            if (std::sscanf(line, "some avg10=%lf avg60=%lf", &avg10, &avg60) == 2) {
+                out.some_avg10 = avg10;
+                out.some_avg60 = avg60;
+            } else if (std::sscanf(line, "full avg10=%lf", &avg10) == 1) {
+                out.full_avg10 = avg10;
+            }
+        }
+        std::fclose(fp);
+        return true;
+    }
+};
+
+// Kernel PSI trigger: POLLPRI when memory stalls exceed `stall_us` within `window_us`
+inline int open_psi_trigger(long stall_us, long window_us) noexcept {
+    const int fd = open(kPsiMemoryPath, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) return -1;
+    char trigger[64];
+    const int len = std::snprintf(trigger, sizeof(trigger), "some %ld %ld", stall_us, window_us);
+    if (write(fd, trigger, static_cast<size_t>(len) + 1) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+} // namespace governor
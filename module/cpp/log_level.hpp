@@ -0,0 +1,19 @@
+#pragma once
+
+// Log levels shared by logger.hpp and logger_lean.hpp
+enum class LogLevel {
+    ERROR = 1,
+    WARN = 2,
+    INFO = 3,
+    DEBUG = 4
+};
+
+inline const char* log_level_string(LogLevel level) noexcept {
+    switch (level) {
+        case LogLevel::ERROR: return "ERROR";
+        case LogLevel::WARN:  return "WARN";
+        case LogLevel::INFO:  return "INFO";
+        case LogLevel::DEBUG: return "DEBUG";
+        default:              return "UNKNOWN";
+    }
+}
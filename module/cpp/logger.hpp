@@ -0,0 +1,371 @@
+#pragma once
+#include "log_level.hpp"
+#include "stats.hpp"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <cstring>
+#include <ctime>
+
+// Linux-specific headers
+#include <sys/stat.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <cerrno>
+
+class Logger {
+private:
+    using StringView = std::string_view;
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+
+    // Configuration
+    std::atomic<bool> running{true};
+    std::atomic<bool> low_power_mode{false};
+    std::atomic<size_t> buffer_max_size{8192};
+    std::atomic<size_t> log_size_limit{102400};
+    std::atomic<LogLevel> log_level{LogLevel::INFO};
+    std::string log_dir;
+    std::mutex log_mutex;
+    std::condition_variable cv;
+    std::string time_buffer;
+    std::mutex time_mutex;
+
+    struct LogFile {
+        std::ofstream stream;
+        size_t current_size{0};
+    };
+    std::map<std::string, std::unique_ptr<LogFile>> log_files;
+
+    struct LogBuffer {
+        std::string content;
+        TimePoint last_write;
+        stats::Id lines_id{stats::kInvalid};
+        stats::Id bytes_id{stats::kInvalid};
+
+        LogBuffer() { content.reserve(16384); }
+    };
+    std::map<std::string, std::unique_ptr<LogBuffer>> log_buffers;
+
+    // Process-wide counters, see stats.hpp
+    struct Counters {
+        stats::Id flushes = stats::counter("log.flushes");
+        stats::Id flushed_bytes = stats::counter("log.flushed_bytes");
+        stats::Id full_flushes = stats::counter("log.buffer_full_flushes");
+        stats::Id error_flushes = stats::counter("log.error_flushes");
+        stats::Id filtered = stats::counter("log.filtered_lines");
+        stats::Id rotations = stats::counter("log.rotations");
+        stats::Id open_errors = stats::counter("log.open_errors");
+        stats::Id write_errors = stats::counter("log.write_errors");
+        stats::Id flush_us = stats::histogram("log.flush_us");
+        stats::Id flush_size = stats::histogram("log.flush_bytes");
+    } counters;
+
+    std::unique_ptr<std::thread> flush_thread;
+
+public:
+    // background_flush=false leaves idle flushing to the owner's event loop (flush_idle)
+    Logger(StringView dir, LogLevel level = LogLevel::INFO, size_t size_limit = 102400, bool background_flush = true)
+        : running(true)
+        , low_power_mode(false)
+        , buffer_max_size(8192)
+        , log_size_limit(size_limit)
+        , log_level(level)
+        , log_dir(dir) {
+        create_log_directory();
+        time_buffer.resize(32);
+        if (background_flush) {
+            flush_thread = std::make_unique<std::thread>(&Logger::flush_thread_func, this);
+        }
+    }
+
+    ~Logger() {
+        stop();
+        if (flush_thread && flush_thread->joinable()) {
+            flush_thread->join();
+        }
+    }
+
+    bool is_running() const noexcept {
+        return running.load(std::memory_order_relaxed);
+    }
+
+    void stop() {
+        if (running.exchange(false)) {
+            cv.notify_all();
+            flush_all();
+            log_files.clear();
+            log_buffers.clear();
+        }
+    }
+
+    void set_buffer_size(size_t size) { buffer_max_size = size; }
+    void set_log_level(LogLevel level) { log_level = level; }
+    void set_log_size_limit(size_t size) { log_size_limit = size; }
+    void set_low_power_mode(bool enabled) {
+        low_power_mode = enabled;
+        buffer_max_size = enabled ? 32768 : 8192;
+        cv.notify_one();
+    }
+
+    void write_log(StringView log_name, LogLevel level, StringView message) {
+        if (level > log_level) {
+            stats::add(counters.filtered);
+            return;
+        }
+        if (!running) return;
+
+        const char* time_str = get_formatted_time();
+        const char* level_str = get_level_string(level);
+        std::string log_entry;
+        log_entry.reserve(100 + message.size());
+        log_entry = time_str;
+        log_entry += " [";
+        log_entry += level_str;
+        log_entry += "] ";
+        log_entry += message;
+        log_entry += "\n";
+        add_to_buffer(std::string(log_name), std::move(log_entry), level);
+    }
+
+    void batch_write(StringView log_name, const std::vector<std::pair<LogLevel, std::string>>& entries) {
+        if (entries.empty() || !running) return;
+
+        std::string batch_content;
+        batch_content.reserve(entries.size() * 100);
+        bool has_error = false;
+        const char* time_str = get_formatted_time();
+
+        for (const auto& [level, msg] : entries) {
+            if (level <= log_level) {
+                const char* level_str = get_level_string(level);
+                batch_content += time_str;
+                batch_content += " [";
+                batch_content += level_str;
+                batch_content += "] ";
+                batch_content += msg;
+                batch_content += "\n";
+                if (level == LogLevel::ERROR) has_error = true;
+            } else {
+                stats::add(counters.filtered);
+            }
+        }
+
+        if (!batch_content.empty()) {
+            add_to_buffer(std::string(log_name), std::move(batch_content), has_error ? LogLevel::ERROR : LogLevel::INFO);
+        }
+    }
+
+    // One pass of the idle flush: buffers quiet for 30s or half full go to disk
+    void flush_idle() {
+        std::lock_guard lock(log_mutex);
+        flush_idle_locked();
+    }
+
+    bool has_pending() {
+        std::lock_guard lock(log_mutex);
+        for (const auto& [_, buffer] : log_buffers) {
+            if (buffer && !buffer->content.empty()) return true;
+        }
+        return false;
+    }
+
+    void flush_buffer(const std::string& log_name) {
+        std::lock_guard lock(log_mutex);
+        flush_buffer_internal(log_name);
+    }
+
+    void flush_all() {
+        std::lock_guard lock(log_mutex);
+        for (const auto& [name, buffer] : log_buffers) {
+            if (buffer && !buffer->content.empty()) {
+                flush_buffer_internal(name);
+            }
+        }
+        for (auto& [_, file] : log_files) {
+            if (file && file->stream.is_open()) {
+                file->stream.flush();
+            }
+        }
+    }
+
+    void clean_logs() {
+        std::lock_guard lock(log_mutex);
+        log_files.clear();
+        log_buffers.clear();
+
+        if (DIR* dir = opendir(log_dir.c_str())) {
+            while (dirent* entry = readdir(dir)) {
+                std::string name = entry->d_name;
+                if (name != "." && name != ".." && 
+                    (name.ends_with(".log") || name.ends_with(".log.old"))) {
+                    std::string path = log_dir + "/" + name;
+                    if (unlink(path.c_str()) != 0) {
+                        std::cerr << "Cannot delete: " << path << " (" << strerror(errno) << ")\n";
+                    }
+                }
+            }
+            closedir(dir);
+        } else {
+            std::cerr << "Cannot open: " << log_dir << " (" << strerror(errno) << ")\n";
+        }
+    }
+
+private:
+    void create_log_directory() {
+        struct stat st;
+        if (stat(log_dir.c_str(), &st) == 0) {
+            if (!S_ISDIR(st.st_mode)) {
+                throw std::runtime_error("Log path exists but is not a directory: " + log_dir);
+            }
+            if (access(log_dir.c_str(), W_OK | X_OK) != 0) {
+                chmod(log_dir.c_str(), 0755);
+            }
+            return;
+        }
+
+        if (mkdir(log_dir.c_str(), 0755) != 0 && errno != EEXIST) {
+            throw std::runtime_error("Cannot create log directory: " + log_dir + " (" + strerror(errno) + ")");
+        }
+        chmod(log_dir.c_str(), 0755);
+    }
+
+    const char* get_level_string(LogLevel level) const noexcept {
+        return log_level_string(level);
+    }
+
+    const char* get_formatted_time() {
+        std::lock_guard lock(time_mutex);
+        auto now = std::chrono::system_clock::now();
+        auto now_time = std::chrono::system_clock::to_time_t(now);
+        std::tm tm;
+        localtime_r(&now_time, &tm);
+        strftime(time_buffer.data(), time_buffer.size(), "%Y-%m-%d %H:%M:%S", &tm);
+        return time_buffer.c_str();
+    }
+
+    void add_to_buffer(std::string log_name, std::string&& content, LogLevel level) {
+        std::lock_guard lock(log_mutex);
+        auto [it, inserted] = log_buffers.try_emplace(log_name, std::make_unique<LogBuffer>());
+        auto& buffer = it->second;
+        if (inserted) {
+            buffer->lines_id = stats::counter("log.lines." + log_name);
+            buffer->bytes_id = stats::counter("log.bytes." + log_name);
+        }
+        stats::add(buffer->lines_id, static_cast<std::uint64_t>(std::count(content.begin(), content.end(), '\n')));
+        stats::add(buffer->bytes_id, content.size());
+        buffer->content += std::move(content);
+        buffer->last_write = Clock::now();
+
+        if (level == LogLevel::ERROR) {
+            stats::add(counters.error_flushes);
+            flush_buffer_internal(log_name);
+        } else if (!low_power_mode && buffer->content.size() >= buffer_max_size) {
+            stats::add(counters.full_flushes);
+            flush_buffer_internal(log_name);
+        }
+        cv.notify_one();
+    }
+
+    void flush_buffer_internal(const std::string& log_name) {
+        auto it = log_buffers.find(log_name);
+        if (it == log_buffers.end() || !it->second || it->second->content.empty()) {
+            return;
+        }
+
+        auto& buffer = it->second;
+        const stats::Timer timer(counters.flush_us);
+        std::string path = log_dir + "/" + log_name + ".log";
+        auto [file_it, inserted] = log_files.try_emplace(log_name, std::make_unique<LogFile>());
+        auto& file = file_it->second;
+
+        if (file->stream.is_open() && file->current_size > log_size_limit) {
+            file->stream.close();
+            std::string old_path = path + ".old";
+            if (access(old_path.c_str(), F_OK) == 0) {
+                unlink(old_path.c_str());
+            }
+            if (rename(path.c_str(), old_path.c_str()) != 0) {
+                std::cerr << "Cannot rename: " << path << " -> " << old_path << " (" << strerror(errno) << ")\n";
+            }
+            file->current_size = 0;
+            stats::add(counters.rotations);
+        }
+
+        if (!file->stream.is_open()) {
+            file->stream.open(path, std::ios::app | std::ios::binary);
+            if (!file->stream.is_open()) {
+                std::cerr << "Cannot open: " << path << " (" << strerror(errno) << ")\n";
+                stats::add(counters.open_errors);
+                buffer->content.clear();
+                return;
+            }
+            file->stream.seekp(0, std::ios::end);
+            file->current_size = static_cast<size_t>(file->stream.tellp());
+        }
+
+        file->stream.write(buffer->content.data(), buffer->content.size());
+        if (file->stream.fail()) {
+            std::cerr << "Failed to write: " << path << "\n";
+            stats::add(counters.write_errors);
+            file->stream.close();
+        } else {
+            file->stream.flush();
+            stats::add(counters.flushes);
+            stats::add(counters.flushed_bytes, buffer->content.size());
+            stats::record(counters.flush_size, buffer->content.size());
+            file->current_size += buffer->content.size();
+            buffer->content.clear();
+        }
+    }
+
+    void flush_thread_func() {
+        while (running) {
+            std::unique_lock lock(log_mutex);
+            cv.wait_for(lock, low_power_mode ? std::chrono::seconds(60) : std::chrono::seconds(15), 
+                        [this] { return !running; });
+
+            if (!running) break;
+            flush_idle_locked();
+        }
+    }
+
+    void flush_idle_locked() {
+        auto now = Clock::now();
+        for (auto it = log_buffers.begin(); it != log_buffers.end();) {
+            auto& buffer = it->second;
+            if (!buffer || buffer->content.empty()) {
+                ++it;
+                continue;
+            }
+
+            auto idle_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                now - buffer->last_write).count();
+            if (idle_time > 30000 || buffer->content.size() > buffer_max_size / 2) {
+                flush_buffer_internal(it->first);
+            }
+            ++it;
+        }
+
+        for (auto it = log_files.begin(); it != log_files.end();) {
+            auto& file = it->second;
+            if (file && file->stream.is_open()) {
+                file->stream.flush();
+                ++it;
+            } else {
+                it = log_files.erase(it);
+            }
+        }
+    }
+};
@@ -0,0 +1,368 @@
+#pragma once
+#include "log_level.hpp"
+#include "stats.hpp"
+#include <string_view>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+
+// Linux-specific headers
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Low-footprint logger for the long-running logmonitor build (-DLOGMONITOR_LEAN).
+// Same file format, rotation and flush policy as logger.hpp, but single-threaded and
+// allocation-free on the write path: a fixed table of log-name slots, each owning one
+// slice of a static arena, flushed with raw write(2); counters go to the static shard
+// of stats.hpp. Nothing here throws, so the binary builds with -fno-exceptions
+// -fno-rtti and without iostreams.
+//
+// Keep the object in static storage: the arena then sits in .bss and only the slices
+// of logs actually written are ever faulted in.
+//
+// Footprint budget for the binary built with the gradle flags (-O3 -flto
+// -static-libstdc++ -fno-exceptions -fno-rtti, gc-sections, stripped), checked by
+// `aurora_bench -c footprint`. Private_Dirty counts the anonymous and COW'd pages
+// reclaim would have to compress. On an x86-64 glibc host the idle daemon measures
+// ~140 kB against ~160 kB for the threaded build, so the dirty-page saving is small;
+// the larger gain is the binary, ~150 kB against ~620 kB of text to page in. The
+// Private_Dirty budget leaves three pages of headroom over the lean build and sits
+// below the threaded one, so a change that costs the lean daemon its saving fails.
+//   idle daemon Private_Dirty (smaps_rollup)   <= kPrivateDirtyBudgetKb
+//   binary size                                <= kBinaryBudgetKb
+class LeanLogger {
+public:
+    static constexpr size_t kPrivateDirtyBudgetKb = 152;
+    static constexpr size_t kBinaryBudgetKb = 192;
+
+    static constexpr size_t kSlots = 8;
+    static constexpr size_t kNameMax = 32;
+    static constexpr size_t kSlotBytes = 16384;   // the full logger's initial reserve
+    static constexpr size_t kFlushBytes = 8192;    // the full logger's buffer_max_size
+    static_assert(sizeof("log.lines.") + kNameMax <= stats::kNameMax, "per-log counter names must fit stats::NameTable");
+
+    LeanLogger() noexcept {
+        for (auto& slot : slots_) slot.fd = -1;
+    }
+
+    LeanLogger(const LeanLogger&) = delete;
+    LeanLogger& operator=(const LeanLogger&) = delete;
+
+    // Creates the directory when needed; false with errno set when it is unusable
+    bool init(std::string_view dir, LogLevel level = LogLevel::INFO, size_t size_limit = 102400) noexcept {
+        if (dir.empty() || dir.size() >= sizeof(dir_)) {
+            errno = ENAMETOOLONG;
+            return false;
+        }
+        std::memcpy(dir_, dir.data(), dir.size());
+        dir_[dir.size()] = '\0';
+        level_ = level;
+        size_limit_ = size_limit;
+
+        struct stat st;
+        if (stat(dir_, &st) == 0) {
+            if (!S_ISDIR(st.st_mode)) {
+                errno = ENOTDIR;
+                return false;
+            }
+            if (access(dir_, W_OK | X_OK) != 0) chmod(dir_, 0755);
+        } else if (mkdir(dir_, 0755) != 0 && errno != EEXIST) {
+            return false;
+        } else {
+            chmod(dir_, 0755);
+        }
+        running_ = true;
+        return true;
+    }
+
+    bool is_running() const noexcept { return running_; }
+
+    void stop() noexcept {
+        if (!running_) return;
+        flush_all();
+        running_ = false;
+        for (auto& slot : slots_) close_slot(slot);
+    }
+
+    void set_low_power_mode(bool enabled) noexcept { low_power_ = enabled; }
+    bool low_power_mode() const noexcept { return low_power_; }
+
+    void write_log(std::string_view log_name, LogLevel level, std::string_view message) noexcept {
+        if (level > level_) {
+            stats::add(counters_.filtered);
+            return;
+        }
+        if (!running_) return;
+        Slot* slot = acquire(log_name);
+        if (!slot) return;
+
+        char head[48];
+        const size_t head_len = format_head(head, sizeof(head), level);
+        const size_t need = head_len + message.size() + 1;
+        stats::add(slot->lines_id, 1 + static_cast<std::uint64_t>(std::count(message.begin(), message.end(), '\n')));
+        stats::add(slot->bytes_id, need);
+
+        if (slot->used + need > kSlotBytes) {
+            flush_slot(*slot);
+            if (slot->used + need > kSlotBytes) slot->used = 0;   // file unwritable, drop the backlog
+        }
+        if (need > kSlotBytes) {
+            write_direct(*slot, head, head_len, message);
+        } else {
+            char* out = buffer(*slot) + slot->used;
+            std::memcpy(out, head, head_len);
+            std::memcpy(out + head_len, message.data(), message.size());
+            out[need - 1] = '\n';
+            slot->used += need;
+        }
+        slot->last_write = Clock::now();
+
+        if (level == LogLevel::ERROR) {
+            stats::add(counters_.error_flushes);
+            flush_slot(*slot);
+        } else if (!low_power_ && slot->used >= kFlushBytes) {
+            stats::add(counters_.full_flushes);
+            flush_slot(*slot);
+        }
+    }
+
+    void flush_buffer(std::string_view log_name) noexcept {
+        if (Slot* slot = find(log_name)) flush_slot(*slot);
+    }
+
+    void flush_all() noexcept {
+        for (auto& slot : slots_) {
+            if (slot.used > 0) flush_slot(slot);
+        }
+    }
+
+    // One pass of the idle flush: buffers quiet for 30s or half full go to disk
+    void flush_idle() noexcept {
+        const auto now = Clock::now();
+        const size_t half = (low_power_ ? kSlotBytes : kFlushBytes) / 2;
+        for (auto& slot : slots_) {
+            if (slot.used == 0) continue;
+            if (now - slot.last_write > std::chrono::seconds(30) || slot.used > half) flush_slot(slot);
+        }
+    }
+
+    void clean_logs() noexcept {
+        for (auto& slot : slots_) {
+            close_slot(slot);
+            slot.name[0] = '\0';
+            slot.used = 0;
+        }
+
+        DIR* dir = opendir(dir_);
+        if (!dir) {
+            std::fprintf(stderr, "Cannot open: %s (%s)\n", dir_, strerror(errno));
+            return;
+        }
+        char path[kPathMax];
+        while (const dirent* entry = readdir(dir)) {
+            const std::string_view name{entry->d_name};
+            if (!name.ends_with(".log") && !name.ends_with(".log.old")) continue;
+            std::snprintf(path, sizeof(path), "%s/%s", dir_, entry->d_name);
+            if (unlink(path) != 0) std::fprintf(stderr, "Cannot delete: %s (%s)\n", path, strerror(errno));
+        }
+        closedir(dir);
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr size_t kPathMax = 320;
+
+    struct Slot {
+        char name[kNameMax];      // empty = free
+        int fd;
+        size_t file_size;
+        size_t used;
+        Clock::time_point last_write;
+        stats::Id lines_id;
+        stats::Id bytes_id;
+    };
+
+    // Same names as logger.hpp so reports read the same for both builds
+    struct Counters {
+        stats::Id flushes = stats::counter("log.flushes");
+        stats::Id flushed_bytes = stats::counter("log.flushed_bytes");
+        stats::Id full_flushes = stats::counter("log.buffer_full_flushes");
+        stats::Id error_flushes = stats::counter("log.error_flushes");
+        stats::Id filtered = stats::counter("log.filtered_lines");
+        stats::Id rotations = stats::counter("log.rotations");
+        stats::Id open_errors = stats::counter("log.open_errors");
+        stats::Id write_errors = stats::counter("log.write_errors");
+        stats::Id flush_us = stats::histogram("log.flush_us");
+        stats::Id flush_size = stats::histogram("log.flush_bytes");
+    } counters_;
+
+    char* buffer(const Slot& slot) noexcept {
+        return arena_[&slot - slots_];
+    }
+
+    Slot* find(std::string_view log_name) noexcept {
+        for (auto& slot : slots_) {
+            if (slot.name[0] != '\0' && log_name == slot.name) return &slot;
+        }
+        return nullptr;
+    }
+
+    // Existing slot for the name, else a free one, else the least recently written
+    Slot* acquire(std::string_view log_name) noexcept {
+        if (Slot* slot = find(log_name)) return slot;
+        if (log_name.empty() || log_name.size() >= kNameMax || log_name.find('/') != std::string_view::npos) {
+            std::fprintf(stderr, "Invalid log name: %.*s\n", static_cast<int>(log_name.size()), log_name.data());
+            return nullptr;
+        }
+
+        Slot* victim = &slots_[0];
+        for (auto& slot : slots_) {
+            if (slot.name[0] == '\0') {
+                victim = &slot;
+                break;
+            }
+            if (slot.last_write < victim->last_write) victim = &slot;
+        }
+        if (victim->name[0] != '\0') {
+            flush_slot(*victim);
+            close_slot(*victim);
+        }
+
+        std::memcpy(victim->name, log_name.data(), log_name.size());
+        victim->name[log_name.size()] = '\0';
+        victim->used = 0;
+        victim->last_write = Clock::now();
+        char counter[kNameMax + 16];
+        std::snprintf(counter, sizeof(counter), "log.lines.%s", victim->name);
+        victim->lines_id = stats::counter(counter);
+        std::snprintf(counter, sizeof(counter), "log.bytes.%s", victim->name);
+        victim->bytes_id = stats::counter(counter);
+        return victim;
+    }
+
+    // "YYYY-mm-dd HH:MM:SS [LEVEL] ", the date part reformatted once per second
+    size_t format_head(char* out, size_t size, LogLevel level) noexcept {
+        const std::time_t now = std::time(nullptr);
+        if (now != cached_second_) {
+            std::tm tm;
+            localtime_r(&now, &tm);
+            cached_len_ = std::strftime(cached_time_, sizeof(cached_time_), "%Y-%m-%d %H:%M:%S", &tm);
+            cached_second_ = now;
+        }
+        const int len = std::snprintf(out, size, "%.*s [%s] ", static_cast<int>(cached_len_), cached_time_,
+                                      log_level_string(level));
+        return len < 0 ? 0 : std::min(static_cast<size_t>(len), size - 1);
+    }
+
+    void path_of(const Slot& slot, char* out, size_t size, const char* suffix) const noexcept {
+        std::snprintf(out, size, "%s/%s.log%s", dir_, slot.name, suffix);
+    }
+
+    bool open_slot(Slot& slot) noexcept {
+        char path[kPathMax];
+        path_of(slot, path, sizeof(path), "");
+        if (slot.fd >= 0 && slot.file_size > size_limit_) {
+            close_slot(slot);
+            char old_path[kPathMax];
+            path_of(slot, old_path, sizeof(old_path), ".old");
+            unlink(old_path);
+            if (rename(path, old_path) != 0) {
+                std::fprintf(stderr, "Cannot rename: %s -> %s (%s)\n", path, old_path, strerror(errno));
+            }
+            stats::add(counters_.rotations);
+        }
+        if (slot.fd >= 0) return true;
+
+        slot.fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (slot.fd < 0) {
+            std::fprintf(stderr, "Cannot open: %s (%s)\n", path, strerror(errno));
+            stats::add(counters_.open_errors);
+            return false;
+        }
+        struct stat st;
+        slot.file_size = fstat(slot.fd, &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+        return true;
+    }
+
+    void close_slot(Slot& slot) noexcept {
+        if (slot.fd >= 0) close(slot.fd);
+        slot.fd = -1;
+        slot.file_size = 0;
+    }
+
+    // writev until everything is out, resuming after short writes
+    bool write_all(Slot& slot, iovec* iov, int count) noexcept {
+        while (count > 0) {
+            const ssize_t n = writev(slot.fd, iov, count);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            slot.file_size += static_cast<size_t>(n);
+            size_t left = static_cast<size_t>(n);
+            while (count > 0 && left >= iov->iov_len) {
+                left -= iov->iov_len;
+                ++iov;
+                --count;
+            }
+            if (count > 0) {
+                iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+                iov->iov_len -= left;
+            }
+        }
+        return true;
+    }
+
+    void flush_slot(Slot& slot) noexcept {
+        if (slot.used == 0) return;
+        const stats::Timer timer(counters_.flush_us);
+        if (!open_slot(slot)) {
+            slot.used = 0;
+            return;
+        }
+        iovec iov{buffer(slot), slot.used};
+        if (!write_all(slot, &iov, 1)) {
+            std::fprintf(stderr, "Failed to write: %s/%s.log (%s)\n", dir_, slot.name, strerror(errno));
+            stats::add(counters_.write_errors);
+            close_slot(slot);
+            return;
+        }
+        stats::add(counters_.flushes);
+        stats::add(counters_.flushed_bytes, slot.used);
+        stats::record(counters_.flush_size, slot.used);
+        slot.used = 0;
+    }
+
+    // Entries larger than a slot bypass the arena
+    void write_direct(Slot& slot, const char* head, size_t head_len, std::string_view message) noexcept {
+        if (!open_slot(slot)) return;
+        char newline = '\n';
+        iovec iov[3] = {{const_cast<char*>(head), head_len},
+                        {const_cast<char*>(message.data()), message.size()},
+                        {&newline, 1}};
+        if (!write_all(slot, iov, 3)) {
+            stats::add(counters_.write_errors);
+            close_slot(slot);
+            return;
+        }
+        stats::add(counters_.flushes);
+        stats::add(counters_.flushed_bytes, head_len + message.size() + 1);
+    }
+
+    Slot slots_[kSlots];
+    char dir_[256];
+    LogLevel level_{LogLevel::INFO};
+    size_t size_limit_{102400};
+    bool low_power_{false};
+    bool running_{false};
+    std::time_t cached_second_{0};
+    size_t cached_len_{0};
+    char cached_time_[24];
+    alignas(4096) char arena_[kSlots][kSlotBytes];
+};
@@ -1,484 +1,292 @@
-#include <iostream>
-#include <fstream>
+#ifdef LOGMONITOR_LEAN
+#include "logger_lean.hpp"
+#else
+#include "logger.hpp"
+#include <memory>
+#include <vector>
+#include <exception>
+#include <pthread.h>
+#endif
 #include <string>
 #include <string_view>
-#include <vector>
-#include <map>
-#include <chrono>
-#include <thread>
-#include <mutex>
-#include <condition_variable>
-#include <atomic>
-#include <memory>
 #include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
 #include <ctime>
 
 // Linux-specific headers
 #include <sys/stat.h>
-#include <dirent.h>
+#include <fcntl.h>
 #include <unistd.h>
-#include <cerrno>
-
-// Log levels
-enum class LogLevel {
-    ERROR = 1,
-    WARN = 2,
-    INFO = 3,
-    DEBUG = 4
-};
-
-class Logger {
-private:
-    using StringView = std::string_view;
-    using Clock = std::chrono::steady_clock;
-    using TimePoint = Clock::time_point;
-
-    // Configuration
-    std::atomic<bool> running{true};
-    std::atomic<bool> low_power_mode{false};
-    std::atomic<size_t> buffer_max_size{8192};
-    std::atomic<size_t> log_size_limit{102400};
-    std::atomic<LogLevel> log_level{LogLevel::INFO};
-    std::string log_dir;
-    std::mutex log_mutex;
-    std::condition_variable cv;
-    std::string time_buffer;
-    std::mutex time_mutex;
-
-    struct LogFile {
-        std::ofstream stream;
-        size_t current_size{0};
-    };
-    std::map<std::string, std::unique_ptr<LogFile>> log_files;
-
-    struct LogBuffer {
-        std::string content;
-        TimePoint last_write;
-
-        LogBuffer() { content.reserve(16384); }
-    };
-    std::map<std::string, std::unique_ptr<LogBuffer>> log_buffers;
-
-    std::unique_ptr<std::thread> flush_thread;
 
-public:
-    Logger(StringView dir, LogLevel level = LogLevel::INFO, size_t size_limit = 102400)
-        : running(true)
-        , low_power_mode(false)
-        , buffer_max_size(8192)
-        , log_size_limit(size_limit)
-        , log_level(level)
-        , log_dir(dir) {
-        create_log_directory();
-        time_buffer.resize(32);
-        flush_thread = std::make_unique<std::thread>(&Logger::flush_thread_func, this);
+// The shipped binary is the lean build (-DLOGMONITOR_LEAN, see logger_lean.hpp): it runs
+// for the whole uptime, so its resident pages are pages zram has to compress. Without
+// the define this builds against the threaded logger.hpp shared with aurorad.
+#ifdef LOGMONITOR_LEAN
+using LogSink = LeanLogger;
+static LeanLogger g_sink;
+#else
+using LogSink = Logger;
+static std::unique_ptr<Logger> g_sink;
+#endif
+static LogSink* g_logger = nullptr;
+static const char* g_stats_file = nullptr;
+static volatile sig_atomic_t g_stop = 0;
+
+constexpr size_t kMaxBatchLine = 4096;
+
+static bool open_logger(const char* dir, LogLevel level) noexcept {
+#ifdef LOGMONITOR_LEAN
+    if (!g_sink.init(dir, level)) {
+        std::fprintf(stderr, "Failed to initialize logger: %s (%s)\n", dir, strerror(errno));
+        return false;
     }
-
-    ~Logger() {
-        stop();
-        if (flush_thread && flush_thread->joinable()) {
-            flush_thread->join();
-        }
-    }
-
-    bool is_running() const noexcept {
-        return running.load(std::memory_order_relaxed);
-    }
-
-    void stop() {
-        if (running.exchange(false)) {
-            cv.notify_all();
-            flush_all();
-            log_files.clear();
-            log_buffers.clear();
-        }
-    }
-
-    void set_buffer_size(size_t size) { buffer_max_size = size; }
-    void set_log_level(LogLevel level) { log_level = level; }
-    void set_log_size_limit(size_t size) { log_size_limit = size; }
-    void set_low_power_mode(bool enabled) {
-        low_power_mode = enabled;
-        buffer_max_size = enabled ? 32768 : 8192;
-        cv.notify_one();
-    }
-
-    void write_log(StringView log_name, LogLevel level, StringView message) {
-        if (level > log_level || !running) return;
-
-        const char* time_str = get_formatted_time();
-        const char* level_str = get_level_string(level);
-        std::string log_entry;
-        log_entry.reserve(100 + message.size());
-        log_entry = time_str;
-        log_entry += " [";
-        log_entry += level_str;
-        log_entry += "] ";
-        log_entry += message;
-        log_entry += "\n";
-        add_to_buffer(std::string(log_name), std::move(log_entry), level);
-    }
-
-    void batch_write(StringView log_name, const std::vector<std::pair<LogLevel, std::string>>& entries) {
-        if (entries.empty() || !running) return;
-
-        std::string batch_content;
-        batch_content.reserve(entries.size() * 100);
-        bool has_error = false;
-        const char* time_str = get_formatted_time();
-
-        for (const auto& [level, msg] : entries) {
-            if (level <= log_level) {
-                const char* level_str = get_level_string(level);
-                batch_content += time_str;
-                batch_content += " [";
-                batch_content += level_str;
-                batch_content += "] ";
-                batch_content += msg;
-                batch_content += "\n";
-                if (level == LogLevel::ERROR) has_error = true;
-            }
-        }
-
-        if (!batch_content.empty()) {
-            add_to_buffer(std::string(log_name), std::move(batch_content), has_error ? LogLevel::ERROR : LogLevel::INFO);
-        }
-    }
-
-    void flush_buffer(const std::string& log_name) {
-        std::lock_guard lock(log_mutex);
-        flush_buffer_internal(log_name);
-    }
-
-    void flush_all() {
-        std::lock_guard lock(log_mutex);
-        for (const auto& [name, buffer] : log_buffers) {
-            if (buffer && !buffer->content.empty()) {
-                flush_buffer_internal(name);
-            }
-        }
-        for (auto& [_, file] : log_files) {
-            if (file && file->stream.is_open()) {
-                file->stream.flush();
-            }
-        }
+    g_logger = &g_sink;
+#else
+    // The flush thread inherits a mask with the stop signals blocked, so they are always
+    // delivered to the main thread and interrupt its sleep in run_daemon
+    sigset_t stop_signals, saved;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGTERM);
+    sigaddset(&stop_signals, SIGINT);
+    pthread_sigmask(SIG_BLOCK, &stop_signals, &saved);
+    try {
+        g_sink = std::make_unique<Logger>(dir, level);
+    } catch (const std::exception& e) {
+        pthread_sigmask(SIG_SETMASK, &saved, nullptr);
+        std::fprintf(stderr, "Failed to initialize logger: %s\n", e.what());
+        return false;
     }
+    pthread_sigmask(SIG_SETMASK, &saved, nullptr);
+    g_logger = g_sink.get();
+#endif
+    return true;
+}
 
-    void clean_logs() {
-        std::lock_guard lock(log_mutex);
-        log_files.clear();
-        log_buffers.clear();
-
-        if (DIR* dir = opendir(log_dir.c_str())) {
-            while (dirent* entry = readdir(dir)) {
-                std::string name = entry->d_name;
-                if (name != "." && name != ".." && 
-                    (name.ends_with(".log") || name.ends_with(".log.old"))) {
-                    std::string path = log_dir + "/" + name;
-                    if (unlink(path.c_str()) != 0) {
-                        std::cerr << "Cannot delete: " << path << " (" << strerror(errno) << ")\n";
-                    }
-                }
-            }
-            closedir(dir);
-        } else {
-            std::cerr << "Cannot open: " << log_dir << " (" << strerror(errno) << ")\n";
-        }
-    }
+// Flushes and, for the threaded build, joins the flush thread
+static void close_logger() noexcept {
+    if (!g_logger) return;
+#ifdef LOGMONITOR_LEAN
+    g_sink.stop();
+#else
+    g_sink.reset();
+#endif
+    g_logger = nullptr;
+}
 
-private:
-    void create_log_directory() {
-        struct stat st;
-        if (stat(log_dir.c_str(), &st) == 0) {
-            if (!S_ISDIR(st.st_mode)) {
-                throw std::runtime_error("Log path exists but is not a directory: " + log_dir);
-            }
-            if (access(log_dir.c_str(), W_OK | X_OK) != 0) {
-                chmod(log_dir.c_str(), 0755);
-            }
-            return;
-        }
+// Only sets the flag: flushing, joining and merging stats allocate and lock, so the main
+// thread does them once its sleep in run_daemon is interrupted
+static void signal_handler(int) {
+    g_stop = 1;
+}
 
-        if (mkdir(log_dir.c_str(), 0755) != 0 && errno != EEXIST) {
-            throw std::runtime_error("Cannot create log directory: " + log_dir + " (" + strerror(errno) + ")");
-        }
-        chmod(log_dir.c_str(), 0755);
-    }
+// 1..4 or ERROR/WARN/INFO/DEBUG; 0 when invalid
+static int parse_level(std::string_view text) noexcept {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+    if (text.size() == 1 && text[0] >= '1' && text[0] <= '4') return text[0] - '0';
+    if (text == "ERROR") return 1;
+    if (text == "WARN") return 2;
+    if (text == "INFO") return 3;
+    if (text == "DEBUG") return 4;
+    return 0;
+}
 
-    const char* get_level_string(LogLevel level) const noexcept {
-        switch (level) {
-            case LogLevel::ERROR: return "ERROR";
-            case LogLevel::WARN:  return "WARN";
-            case LogLevel::INFO:  return "INFO";
-            case LogLevel::DEBUG: return "DEBUG";
-            default:              return "UNKNOWN";
-        }
+static void run_daemon(bool low_power) {
+    umask(0022);
+    struct sigaction sa{};
+    sa.sa_handler = signal_handler;
+    sigaction(SIGTERM, &sa, nullptr);
+    sigaction(SIGINT, &sa, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    g_logger->write_log("main", LogLevel::INFO, low_power ? "Daemon started (low power)" : "Daemon started");
+
+#ifdef LOGMONITOR_LEAN
+    // The flush thread of logger.hpp, folded into the main thread
+    while (!g_stop) {
+        timespec delay{low_power ? 60 : 15, 0};
+        nanosleep(&delay, nullptr);
+        g_logger->flush_idle();
     }
-
-    const char* get_formatted_time() {
-        std::lock_guard lock(time_mutex);
-        auto now = std::chrono::system_clock::now();
-        auto now_time = std::chrono::system_clock::to_time_t(now);
-        std::tm tm;
-        localtime_r(&now_time, &tm);
-        strftime(time_buffer.data(), time_buffer.size(), "%Y-%m-%d %H:%M:%S", &tm);
-        return time_buffer.c_str();
+#else
+    // The logger's own thread flushes; this one only waits for a stop signal
+    while (!g_stop && g_logger->is_running()) {
+        timespec delay{3600, 0};
+        nanosleep(&delay, nullptr);
     }
+#endif
 
-    void add_to_buffer(std::string log_name, std::string&& content, LogLevel level) {
-        std::lock_guard lock(log_mutex);
-        auto [it, inserted] = log_buffers.try_emplace(log_name, std::make_unique<LogBuffer>());
-        auto& buffer = it->second;
-        buffer->content += std::move(content);
-        buffer->last_write = Clock::now();
+    g_logger->write_log("main", LogLevel::INFO, "Daemon stopping");
+}
 
-        if (level == LogLevel::ERROR || (!low_power_mode && buffer->content.size() >= buffer_max_size)) {
-            flush_buffer_internal(log_name);
-        }
-        cv.notify_one();
+// Batch input: one "level|message" per line, # comments allowed
+static int run_batch(const char* batch_file, std::string_view log_name) {
+    const int fd = open(batch_file, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::fprintf(stderr, "Cannot open batch file: %s (%s)\n", batch_file, strerror(errno));
+        return 1;
     }
 
-    void flush_buffer_internal(const std::string& log_name) {
-        auto it = log_buffers.find(log_name);
-        if (it == log_buffers.end() || !it->second || it->second->content.empty()) {
+#ifndef LOGMONITOR_LEAN
+    std::vector<std::pair<LogLevel, std::string>> entries;
+#endif
+    auto handle_line = [&](std::string_view line, int line_num) {
+        if (line.empty() || line[0] == '#') return;
+        const size_t pos = line.find('|');
+        if (pos == std::string_view::npos) {
+            std::fprintf(stderr, "Line %d: invalid format\n", line_num);
             return;
         }
-
-        auto& buffer = it->second;
-        std::string path = log_dir + "/" + log_name + ".log";
-        auto [file_it, inserted] = log_files.try_emplace(log_name, std::make_unique<LogFile>());
-        auto& file = file_it->second;
-
-        if (file->stream.is_open() && file->current_size > log_size_limit) {
-            file->stream.close();
-            std::string old_path = path + ".old";
-            if (access(old_path.c_str(), F_OK) == 0) {
-                unlink(old_path.c_str());
-            }
-            if (rename(path.c_str(), old_path.c_str()) != 0) {
-                std::cerr << "Cannot rename: " << path << " -> " << old_path << " (" << strerror(errno) << ")\n";
-            }
-            file->current_size = 0;
+        const int lvl = parse_level(line.substr(0, pos));
+        if (lvl == 0) {
+            std::fprintf(stderr, "Line %d: invalid level: %.*s\n", line_num, static_cast<int>(pos), line.data());
         }
+        const LogLevel level = lvl ? static_cast<LogLevel>(lvl) : LogLevel::INFO;
+        std::string_view msg = line.substr(pos + 1);
+        while (!msg.empty() && (msg.front() == ' ' || msg.front() == '\t')) msg.remove_prefix(1);
+#ifdef LOGMONITOR_LEAN
+        g_logger->write_log(log_name, level, msg);
+#else
+        entries.emplace_back(level, std::string(msg));
+#endif
+    };
 
-        if (!file->stream.is_open()) {
-            file->stream.open(path, std::ios::app | std::ios::binary);
-            if (!file->stream.is_open()) {
-                std::cerr << "Cannot open: " << path << " (" << strerror(errno) << ")\n";
-                buffer->content.clear();
-                return;
-            }
-            file->stream.seekp(0, std::ios::end);
-            file->current_size = static_cast<size_t>(file->stream.tellp());
+    // Lines longer than the buffer are cut at kMaxBatchLine
+    char buf[kMaxBatchLine];
+    size_t used = 0;
+    int line_num = 0;
+    bool skipping = false;
+    for (;;) {
+        const ssize_t n = read(fd, buf + used, sizeof(buf) - used);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        used += static_cast<size_t>(n);
+
+        size_t start = 0;
+        for (size_t i = start; i < used; ++i) {
+            if (buf[i] != '\n') continue;
+            ++line_num;
+            if (!skipping) handle_line(std::string_view(buf + start, i - start), line_num);
+            skipping = false;
+            start = i + 1;
         }
-
-        file->stream.write(buffer->content.data(), buffer->content.size());
-        if (file->stream.fail()) {
-            std::cerr << "Failed to write: " << path << "\n";
-            file->stream.close();
+        if (start == 0 && used == sizeof(buf)) {
+            handle_line(std::string_view(buf, used), line_num + 1);
+            skipping = true;
+            used = 0;
         } else {
-            file->stream.flush();
-            file->current_size += buffer->content.size();
-            buffer->content.clear();
+            std::memmove(buf, buf + start, used - start);
+            used -= start;
         }
     }
+    if (used > 0 && !skipping) handle_line(std::string_view(buf, used), ++line_num);
+    close(fd);
 
-    void flush_thread_func() {
-        while (running) {
-            std::unique_lock lock(log_mutex);
-            cv.wait_for(lock, low_power_mode ? std::chrono::seconds(60) : std::chrono::seconds(15), 
-                        [this] { return !running; });
-
-            if (!running) break;
-
-            auto now = Clock::now();
-            for (auto it = log_buffers.begin(); it != log_buffers.end();) {
-                auto& buffer = it->second;
-                if (!buffer || buffer->content.empty()) {
-                    ++it;
-                    continue;
-                }
-
-                auto idle_time = std::chrono::duration_cast<std::chrono::milliseconds>(
-                    now - buffer->last_write).count();
-                if (idle_time > 30000 || buffer->content.size() > buffer_max_size / 2) {
-                    flush_buffer_internal(it->first);
-                }
-                ++it;
-            }
-
-            for (auto it = log_files.begin(); it != log_files.end();) {
-                auto& file = it->second;
-                if (file && file->stream.is_open()) {
-                    file->stream.flush();
-                    ++it;
-                } else {
-                    it = log_files.erase(it);
-                }
-            }
-        }
-    }
-};
-
-static std::unique_ptr<Logger> g_logger;
+#ifndef LOGMONITOR_LEAN
+    if (!entries.empty()) g_logger->batch_write(log_name, entries);
+#endif
+    g_logger->flush_buffer(std::string(log_name));
+    return 0;
+}
 
-void signal_handler(int sig) {
-    if (g_logger && (sig == SIGTERM || sig == SIGINT)) {
-        g_logger->flush_all();
-        g_logger->stop();
-        _exit(0);
-    }
+static void print_usage(const char* prog) noexcept {
+    std::printf("Usage: %s [options]\n", prog);
+    std::printf("Options:\n");
+    std::printf("  -d DIR    Log directory (default: /data/adb/modules/AMMF2/logs)\n");
+    std::printf("  -l LEVEL  Log level (1=Error, 2=Warn, 3=Info, 4=Debug, default: 3)\n");
+    std::printf("  -c CMD    Command (daemon, write, batch, flush, clean, stats)\n");
+    std::printf("  -n NAME   Log name (default: main)\n");
+    std::printf("  -m MSG    Log message\n");
+    std::printf("  -b FILE   Batch input file (format: level|message)\n");
+    std::printf("  -p        Low power mode\n");
+    std::printf("  -S FILE   Add this process's counters to FILE on exit; stats prints FILE as JSON\n");
+    std::printf("  -h        Show help\n");
 }
 
 int main(int argc, char* argv[]) {
-    std::string log_dir = "/data/adb/modules/zram/logs";
+    const char* log_dir = "/data/adb/modules/zram/logs";
     LogLevel log_level = LogLevel::INFO;
-    std::string command;
-    std::string log_name = "main";
-    std::string message;
-    std::string batch_file;
+    std::string_view command;
+    std::string_view log_name = "main";
+    const char* message = nullptr;
+    const char* batch_file = nullptr;
     bool low_power = false;
 
     for (int i = 1; i < argc; ++i) {
-        std::string arg = argv[i];
+        const std::string_view arg{argv[i]};
         if (arg == "-d" && ++i < argc) log_dir = argv[i];
         else if (arg == "-l" && ++i < argc) {
-            try {
-                int lvl = std::stoi(argv[i]);
-                if (lvl >= static_cast<int>(LogLevel::ERROR) && lvl <= static_cast<int>(LogLevel::DEBUG)) {
-                    log_level = static_cast<LogLevel>(lvl);
-                } else {
-                    std::cerr << "Invalid log level: " << argv[i] << "\n";
-                    return 1;
-                }
-            } catch (const std::exception& e) {
-                std::cerr << "Invalid log level: " << argv[i] << "\n";
+            char* end = nullptr;
+            const long lvl = std::strtol(argv[i], &end, 10);
+            if (end == argv[i] || lvl < static_cast<int>(LogLevel::ERROR) || lvl > static_cast<int>(LogLevel::DEBUG)) {
+                std::fprintf(stderr, "Invalid log level: %s\n", argv[i]);
                 return 1;
             }
+            log_level = static_cast<LogLevel>(lvl);
         }
         else if (arg == "-c" && ++i < argc) command = argv[i];
         else if (arg == "-n" && ++i < argc) log_name = argv[i];
         else if (arg == "-m" && ++i < argc) message = argv[i];
         else if (arg == "-b" && ++i < argc) batch_file = argv[i];
+        else if (arg == "-S" && ++i < argc) g_stats_file = argv[i];
         else if (arg == "-p") low_power = true;
         else if (arg == "-h" || arg == "--help") {
-            std::cout << "Usage: " << argv[0] << " [options]\n"
-                      << "Options:\n"
-                      << "  -d DIR    Log directory (default: /data/adb/modules/AMMF2/logs)\n"
-                      << "  -l LEVEL  Log level (1=Error, 2=Warn, 3=Info, 4=Debug, default: 3)\n"
-                      << "  -c CMD    Command (daemon, write, batch, flush, clean)\n"
-                      << "  -n NAME   Log name (default: main)\n"
-                      << "  -m MSG    Log message\n"
-                      << "  -b FILE   Batch input file (format: level|message)\n"
-                      << "  -p        Low power mode\n"
-                      << "  -h        Show help\n";
+            print_usage(argv[0]);
             return 0;
         } else {
-            std::cerr << "Unknown argument: " << arg << "\n";
+            std::fprintf(stderr, "Unknown argument: %s\n", argv[i]);
             return 1;
         }
     }
 
     if (command.empty()) command = "daemon";
 
-    try {
-        g_logger = std::make_unique<Logger>(log_dir, log_level);
-        if (low_power) g_logger->set_low_power_mode(true);
-    } catch (const std::exception& e) {
-        std::cerr << "Failed to initialize logger: " << e.what() << "\n";
-        return 1;
+    if (command == "stats") {
+        std::string json;
+        if (!g_stats_file) {
+            std::fprintf(stderr, "Stats file required (-S)\n");
+            return 1;
+        }
+        if (!stats::accumulated_json(g_stats_file, json)) {
+            std::fprintf(stderr, "Cannot open: %s (%s)\n", g_stats_file, strerror(errno));
+            return 1;
+        }
+        std::fwrite(json.data(), 1, json.size(), stdout);
+        return 0;
     }
 
-    if (command == "daemon") {
-        umask(0022);
-        signal(SIGTERM, signal_handler);
-        signal(SIGINT, signal_handler);
-        signal(SIGPIPE, SIG_IGN);
-
-        g_logger->write_log("main", LogLevel::INFO, 
-                            low_power ? "Daemon started (low power)" : "Daemon started");
+    if (!open_logger(log_dir, log_level)) return 1;
+    if (low_power) g_logger->set_low_power_mode(true);
 
-        std::mutex mtx;
-        std::condition_variable cv;
-        std::unique_lock lock(mtx);
-        while (g_logger && g_logger->is_running()) {
-            cv.wait_for(lock, std::chrono::hours(1));
-        }
-
-        g_logger->write_log("main", LogLevel::INFO, "Daemon stopping");
-        return 0;
+    int rc = 0;
+    if (command == "daemon") {
+        run_daemon(low_power);
     } else if (command == "write") {
-        if (message.empty()) {
-            std::cerr << "Message required for write command\n";
+        if (!message || !*message) {
+            std::fprintf(stderr, "Message required for write command\n");
             return 1;
         }
         g_logger->write_log(log_name, log_level, message);
-        g_logger->flush_buffer(log_name);
+        g_logger->flush_buffer(std::string(log_name));
     } else if (command == "batch") {
-        if (batch_file.empty()) {
-            std::cerr << "Batch file required for batch command\n";
-            return 1;
-        }
-
-        std::ifstream in(batch_file);
-        if (!in) {
-            std::cerr << "Cannot open batch file: " << batch_file << " (" << strerror(errno) << ")\n";
+        if (!batch_file) {
+            std::fprintf(stderr, "Batch file required for batch command\n");
             return 1;
         }
-
-        std::vector<std::pair<LogLevel, std::string>> entries;
-        std::string line;
-        int line_num = 0;
-
-        while (std::getline(in, line)) {
-            ++line_num;
-            if (line.empty() || line[0] == '#') continue;
-
-            size_t pos = line.find('|');
-            if (pos == std::string::npos) {
-                std::cerr << "Line " << line_num << ": invalid format\n";
-                continue;
-            }
-
-            std::string level_str = line.substr(0, pos);
-            level_str.erase(0, level_str.find_first_not_of(" \t"));
-            level_str.erase(level_str.find_last_not_of(" \t") + 1);
-
-            LogLevel level = LogLevel::INFO;
-            try {
-                int lvl = std::stoi(level_str);
-                if (lvl >= static_cast<int>(LogLevel::ERROR) && lvl <= static_cast<int>(LogLevel::DEBUG)) {
-                    level = static_cast<LogLevel>(lvl);
-                } else {
-                    std::cerr << "Line " << line_num << ": invalid level: " << level_str << "\n";
-                }
-            } catch (const std::exception&) {
-                if (level_str == "ERROR") level = LogLevel::ERROR;
-                else if (level_str == "WARN") level = LogLevel::WARN;
-                else if (level_str == "INFO") level = LogLevel::INFO;
-                else if (level_str == "DEBUG") level = LogLevel::DEBUG;
-                else {
-                    std::cerr << "Line " << line_num << ": invalid level: " << level_str << "\n";
-                }
-            }
-
-            std::string msg = line.substr(pos + 1);
-            msg.erase(0, msg.find_first_not_of(" \t"));
-            entries.emplace_back(level, std::move(msg));
-        }
-
-        if (!entries.empty()) {
-            g_logger->batch_write(log_name, entries);
-            g_logger->flush_buffer(log_name);
-        }
+        rc = run_batch(batch_file, log_name);
     } else if (command == "flush") {
         g_logger->flush_all();
     } else if (command == "clean") {
         g_logger->clean_logs();
     } else {
-        std::cerr << "Unknown command: " << command << "\n";
+        std::fprintf(stderr, "Unknown command: %.*s\n", static_cast<int>(command.size()), command.data());
         return 1;
     }
 
-    return 0;
-}
\ No newline at end of file
+    close_logger();
+    if (g_stats_file) stats::merge_into(g_stats_file);
+    return rc;
+}
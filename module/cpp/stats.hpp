@@ -0,0 +1,406 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+// Linux-specific headers
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Hot-path counters and latency histograms. Names are registered once (mutex) and
+// return a small id; updates go to a per-thread shard with plain relaxed stores, so
+// the hot path never shares a cache line or takes a lock. Readers sum the shards.
+// Histograms use power-of-two buckets: bucket b holds values in [2^(b-1), 2^b).
+// The lean logmonitor (-DLOGMONITOR_LEAN) is single-threaded and keeps its write path
+// allocation-free: names go into fixed tables and there is one static shard.
+namespace stats {
+
+using Id = std::uint16_t;
+constexpr Id kInvalid = 0xffff;
+#ifdef LOGMONITOR_LEAN
+// The lean logger's 10 fixed names plus two per log name, with room for evicted names
+constexpr size_t kMaxCounters = 64;
+constexpr size_t kMaxHistograms = 2;
+#else
+constexpr size_t kMaxCounters = 128;
+constexpr size_t kMaxHistograms = 16;
+#endif
+constexpr int kBuckets = 32;
+constexpr size_t kNameMax = 48;   // longest name the lean build's fixed tables hold, with NUL
+
+struct HistogramCells {
+    std::array<std::atomic<std::uint64_t>, kBuckets> buckets{};
+    std::atomic<std::uint64_t> count{0};
+    std::atomic<std::uint64_t> sum{0};
+    std::atomic<std::uint64_t> max{0};
+};
+
+struct Shard {
+    std::array<std::atomic<std::uint64_t>, kMaxCounters> counters{};
+    std::array<HistogramCells, kMaxHistograms> histograms{};
+};
+
+// Merged view, also the unit of the on-disk accumulation file
+struct Histogram {
+    std::uint64_t buckets[kBuckets]{};
+    std::uint64_t count{0};
+    std::uint64_t sum{0};
+    std::uint64_t max{0};
+
+    void merge(const Histogram& other) noexcept {
+        for (int b = 0; b < kBuckets; ++b) buckets[b] += other.buckets[b];
+        count += other.count;
+        sum += other.sum;
+        max = std::max(max, other.max);
+    }
+
+    // Upper bound of the bucket holding the given quantile
+    std::uint64_t quantile(double q) const noexcept {
+        if (count == 0) return 0;
+        const auto rank = static_cast<std::uint64_t>(q * static_cast<double>(count - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (int b = 0; b < kBuckets; ++b) {
+            seen += buckets[b];
+            if (seen >= rank) return std::min(max, b == 0 ? 0 : (std::uint64_t{1} << b) - 1);
+        }
+        return max;
+    }
+};
+
+#ifdef LOGMONITOR_LEAN
+template <size_t N>
+class NameTable {
+public:
+    size_t size() const noexcept { return size_; }
+    std::string_view operator[](size_t i) const noexcept { return names_[i]; }
+
+    // False when the table is full or the name does not fit
+    bool add(std::string_view name) noexcept {
+        if (size_ >= N || name.size() >= kNameMax) return false;
+        std::memcpy(names_[size_], name.data(), name.size());
+        names_[size_++][name.size()] = '\0';
+        return true;
+    }
+
+private:
+    char names_[N][kNameMax]{};
+    size_t size_{0};
+};
+#endif
+
+struct Snapshot {
+    std::vector<std::pair<std::string, std::uint64_t>> counters;
+    std::vector<std::pair<std::string, Histogram>> histograms;
+};
+
+class Registry {
+public:
+    static Registry& instance() noexcept {
+        static Registry registry;
+        return registry;
+    }
+
+    Id counter(std::string_view name) noexcept { return lookup(counter_names_, kMaxCounters, name); }
+    Id histogram(std::string_view name) noexcept { return lookup(histogram_names_, kMaxHistograms, name); }
+
+    Shard& local() noexcept {
+#ifdef LOGMONITOR_LEAN
+        return shard_;
+#else
+        thread_local Shard* shard = nullptr;
+        if (!shard) {
+            // Shards outlive their threads so totals from finished workers are kept
+            shard = new Shard;
+            std::lock_guard lock(mutex_);
+            shards_.push_back(shard);
+        }
+        return *shard;
+#endif
+    }
+
+    Snapshot snapshot() noexcept {
+        std::lock_guard lock(mutex_);
+        Snapshot out;
+        out.counters.reserve(counter_names_.size());
+        for (size_t i = 0; i < counter_names_.size(); ++i) {
+            std::uint64_t total = 0;
+            for (const Shard* shard : shards()) total += shard->counters[i].load(std::memory_order_relaxed);
+            out.counters.emplace_back(counter_names_[i], total);
+        }
+        out.histograms.reserve(histogram_names_.size());
+        for (size_t i = 0; i < histogram_names_.size(); ++i) {
+            Histogram total;
+            for (const Shard* shard : shards()) {
+                const auto& cells = shard->histograms[i];
+                for (int b = 0; b < kBuckets; ++b) total.buckets[b] += cells.buckets[static_cast<size_t>(b)].load(std::memory_order_relaxed);
+                total.count += cells.count.load(std::memory_order_relaxed);
+                total.sum += cells.sum.load(std::memory_order_relaxed);
+                total.max = std::max(total.max, cells.max.load(std::memory_order_relaxed));
+            }
+            out.histograms.emplace_back(histogram_names_[i], total);
+        }
+        return out;
+    }
+
+private:
+    std::mutex mutex_;
+#ifdef LOGMONITOR_LEAN
+    // All zero, so the Registry stays in .bss (no stored pointers to it) and only the
+    // pages in use are faulted in
+    NameTable<kMaxCounters> counter_names_;
+    NameTable<kMaxHistograms> histogram_names_;
+    Shard shard_;
+
+    std::array<const Shard*, 1> shards() const noexcept { return {&shard_}; }
+#else
+    std::vector<std::string> counter_names_;
+    std::vector<std::string> histogram_names_;
+    std::vector<Shard*> shards_;
+
+    const std::vector<Shard*>& shards() const noexcept { return shards_; }
+#endif
+
+    template <typename Names>
+    Id lookup(Names& names, size_t limit, std::string_view name) noexcept {
+        std::lock_guard lock(mutex_);
+        for (size_t i = 0; i < names.size(); ++i) {
+            if (names[i] == name) return static_cast<Id>(i);
+        }
+        if (names.size() >= limit) return kInvalid;
+#ifdef LOGMONITOR_LEAN
+        if (!names.add(name)) return kInvalid;
+#else
+        names.emplace_back(name);
+#endif
+        return static_cast<Id>(names.size() - 1);
+    }
+};
+
+inline Id counter(std::string_view name) noexcept { return Registry::instance().counter(name); }
+inline Id histogram(std::string_view name) noexcept { return Registry::instance().histogram(name); }
+
+// Single writer per shard: load + store instead of a locked read-modify-write
+inline void bump(std::atomic<std::uint64_t>& cell, std::uint64_t n) noexcept {
+    cell.store(cell.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+inline void add(Id id, std::uint64_t n = 1) noexcept {
+    if (id < kMaxCounters) bump(Registry::instance().local().counters[id], n);
+}
+
+inline int bucket_of(std::uint64_t value) noexcept {
+    return value == 0 ? 0 : std::min(kBuckets - 1, 64 - __builtin_clzll(value));
+}
+
+inline void record(Id id, std::uint64_t value) noexcept {
+    if (id >= kMaxHistograms) return;
+    auto& cells = Registry::instance().local().histograms[id];
+    bump(cells.buckets[static_cast<size_t>(bucket_of(value))], 1);
+    bump(cells.count, 1);
+    bump(cells.sum, value);
+    if (value > cells.max.load(std::memory_order_relaxed)) cells.max.store(value, std::memory_order_relaxed);
+}
+
+// Records the scope's duration in microseconds
+class Timer {
+public:
+    explicit Timer(Id id) noexcept : id_(id), start_(std::chrono::steady_clock::now()) {}
+    ~Timer() {
+        record(id_, static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start_).count()));
+    }
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+
+private:
+    Id id_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+inline void append_escaped(std::string& out, std::string_view text) {
+    for (const char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20) out += c;
+    }
+}
+
+inline std::string to_json(const Snapshot& snap) {
+    std::string out = "{\"counters\":{";
+    char num[160];
+    bool first = true;
+    for (const auto& [name, value] : snap.counters) {
+        out += first ? "\"" : ",\"";
+        append_escaped(out, name);
+        std::snprintf(num, sizeof(num), "\":%llu", static_cast<unsigned long long>(value));
+        out += num;
+        first = false;
+    }
+    out += "},\"histograms\":{";
+    first = true;
+    for (const auto& [name, h] : snap.histograms) {
+        out += first ? "\"" : ",\"";
+        append_escaped(out, name);
+        std::snprintf(num, sizeof(num), "\":{\"count\":%llu,\"sum\":%llu,\"max\":%llu,\"p50\":%llu,\"p90\":%llu,\"p99\":%llu,\"buckets\":[",
+                      static_cast<unsigned long long>(h.count), static_cast<unsigned long long>(h.sum),
+                      static_cast<unsigned long long>(h.max), static_cast<unsigned long long>(h.quantile(0.5)),
+                      static_cast<unsigned long long>(h.quantile(0.9)), static_cast<unsigned long long>(h.quantile(0.99)));
+        out += num;
+        // Only non-empty buckets, as [upper bound, count]
+        bool first_bucket = true;
+        for (int b = 0; b < kBuckets; ++b) {
+            if (h.buckets[b] == 0) continue;
+            std::snprintf(num, sizeof(num), "%s[%llu,%llu]", first_bucket ? "" : ",",
+                          b == 0 ? 0ULL : (1ULL << b) - 1, static_cast<unsigned long long>(h.buckets[b]));
+            out += num;
+            first_bucket = false;
+        }
+        out += "]}";
+        first = false;
+    }
+    out += "}}\n";
+    return out;
+}
+
+inline std::string snapshot_json() { return to_json(Registry::instance().snapshot()); }
+
+inline bool write_all(int fd, std::string_view data) noexcept {
+    while (!data.empty()) {
+        const ssize_t n = write(fd, data.data(), data.size());
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data.remove_prefix(static_cast<size_t>(n));
+    }
+    return true;
+}
+
+// Atomic replace, readers never see a half-written snapshot
+inline bool write_json(const std::string& path) {
+    const std::string tmp = path + ".tmp";
+    const int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    const bool ok = write_all(fd, snapshot_json());
+    close(fd);
+    return ok && rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+// Accumulation file for short-lived processes (one logmonitor per shell log line):
+// each process adds its totals under flock. Text lines:
+//   c <name> <value>
+//   h <name> <count> <sum> <max> <bucket0> .. <bucket31>
+inline Snapshot parse_accumulated(std::string_view text) {
+    Snapshot snap;
+    while (!text.empty()) {
+        const size_t eol = std::min(text.find('\n'), text.size());
+        std::string line{text.substr(0, eol)};
+        text.remove_prefix(std::min(eol + 1, text.size()));
+
+        char* cursor = line.data();
+        const char kind = *cursor;
+        if ((kind != 'c' && kind != 'h') || cursor[1] != ' ') continue;
+        char* name = cursor + 2;
+        char* space = std::strchr(name, ' ');
+        if (!space) continue;
+        *space = '\0';
+        cursor = space + 1;
+
+        if (kind == 'c') {
+            snap.counters.emplace_back(name, std::strtoull(cursor, nullptr, 10));
+            continue;
+        }
+        Histogram h;
+        h.count = std::strtoull(cursor, &cursor, 10);
+        h.sum = std::strtoull(cursor, &cursor, 10);
+        h.max = std::strtoull(cursor, &cursor, 10);
+        for (int b = 0; b < kBuckets; ++b) h.buckets[b] = std::strtoull(cursor, &cursor, 10);
+        snap.histograms.emplace_back(name, h);
+    }
+    return snap;
+}
+
+// Names are space-separated fields in the file
+inline std::string field_name(std::string name) {
+    std::replace(name.begin(), name.end(), ' ', '_');
+    std::replace(name.begin(), name.end(), '\n', '_');
+    return name;
+}
+
+inline std::string format_accumulated(const Snapshot& snap) {
+    std::string out;
+    char num[32];
+    for (const auto& [name, value] : snap.counters) {
+        std::snprintf(num, sizeof(num), " %llu\n", static_cast<unsigned long long>(value));
+        out += "c " + field_name(name) + num;
+    }
+    for (const auto& [name, h] : snap.histograms) {
+        out += "h " + field_name(name);
+        for (const std::uint64_t v : {h.count, h.sum, h.max}) {
+            std::snprintf(num, sizeof(num), " %llu", static_cast<unsigned long long>(v));
+            out += num;
+        }
+        for (const std::uint64_t v : h.buckets) {
+            std::snprintf(num, sizeof(num), " %llu", static_cast<unsigned long long>(v));
+            out += num;
+        }
+        out += '\n';
+    }
+    return out;
+}
+
+inline std::string read_locked(int fd) {
+    std::string text;
+    char buf[4096];
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0) text.append(buf, static_cast<size_t>(n));
+    return text;
+}
+
+inline bool merge_into(const std::string& path) {
+    Snapshot own = Registry::instance().snapshot();
+    const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    flock(fd, LOCK_EX);
+
+    Snapshot merged = parse_accumulated(read_locked(fd));
+    for (auto& [name, value] : own.counters) {
+        if (value == 0) continue;
+        auto it = std::find_if(merged.counters.begin(), merged.counters.end(), [&](const auto& c) { return c.first == field_name(name); });
+        if (it == merged.counters.end()) merged.counters.emplace_back(field_name(name), value);
+        else it->second += value;
+    }
+    for (auto& [name, h] : own.histograms) {
+        if (h.count == 0) continue;
+        auto it = std::find_if(merged.histograms.begin(), merged.histograms.end(), [&](const auto& e) { return e.first == field_name(name); });
+        if (it == merged.histograms.end()) merged.histograms.emplace_back(field_name(name), h);
+        else it->second.merge(h);
+    }
+
+    const std::string text = format_accumulated(merged);
+    const bool ok = ftruncate(fd, 0) == 0 && lseek(fd, 0, SEEK_SET) == 0 && write_all(fd, text);
+    flock(fd, LOCK_UN);
+    close(fd);
+    return ok;
+}
+
+inline bool accumulated_json(const std::string& path, std::string& out) {
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    flock(fd, LOCK_SH);
+    out = to_json(parse_accumulated(read_locked(fd)));
+    close(fd);
+    return true;
+}
+
+} // namespace stats
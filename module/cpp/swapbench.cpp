@@ -0,0 +1,696 @@
+#include "zram_sysfs.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <memory>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <ctime>
+#include <csignal>
+
+// Linux-specific headers
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/swap.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifndef SWAP_FLAG_PREFER
+#define SWAP_FLAG_PREFER 0x8000
+#endif
+#ifndef SWAP_FLAG_PRIO_MASK
+#define SWAP_FLAG_PRIO_MASK 0x7fff
+#endif
+#ifndef MADV_PAGEOUT
+#define MADV_PAGEOUT 21
+#endif
+
+// Swap-in latency of a real zram swap device: a scratch device is configured and
+// swapped on above every other swap, a synthetic working set is pushed out to it
+// (memcg limit or MADV_PAGEOUT) and then re-faulted with a given access pattern.
+// Each swap-in is timed individually; pagemap tells faults from resident hits.
+
+using zram::Clock;
+using zram::elapsed_ms;
+
+constexpr size_t kPageSize = 4096;
+constexpr std::uint64_t kPmSwapped = 1ULL << 62;
+
+// Set on SIGINT/SIGTERM/SIGHUP; the current run stops at the next access and the
+// scratch device, memcg and zstd level are cleaned up as on a normal exit
+static volatile sig_atomic_t g_stop = 0;
+
+static void signal_handler(int) {
+    g_stop = 1;
+}
+
+enum class Method { Memcg, Pageout };
+enum class Pattern { Sequential, Random, Zipf };
+
+// ALGO[:LEVEL][+RECOMP_ALGO][@wb]
+struct SwapConfig {
+    std::string algorithm;
+    int level{0};
+    std::string recompress;
+    bool writeback{false};
+    std::string label;
+};
+
+struct Options {
+    std::string device;
+    std::string backing_dev;
+    std::string output;
+    std::vector<std::string> configs;
+    std::vector<double> entropies{0.5};
+    std::vector<Pattern> patterns{Pattern::Sequential, Pattern::Random, Pattern::Zipf};
+    Method method{Method::Memcg};
+    bool method_set{false};
+    size_t pages{16384};        // 64 MiB
+    size_t accesses{0};         // 0 = one per page
+    int resident_pct{25};
+    double zipf_theta{0.99};
+};
+
+struct RunResult {
+    SwapConfig config;
+    double entropy{0};
+    Pattern pattern{Pattern::Sequential};
+    size_t swapped{0};          // working set pages on swap before re-faulting
+    double push_ms{0};
+    zram::MmStat mm;
+    double recompress_ms{-1};
+    zram::MmStat mm_recompressed;
+    double writeback_ms{-1};
+    unsigned long long bd_writes{0};
+    size_t accesses{0};
+    size_t swapins{0};
+    double seconds{0};
+    double cpu_user_ms{0};
+    double cpu_sys_ms{0};
+    long major_faults{0};
+    double p50_us{0}, p90_us{0}, p99_us{0}, p999_us{0}, max_us{0};
+};
+
+struct MapFree {
+    size_t bytes;
+    void operator()(char* ptr) const noexcept { munmap(ptr, bytes); }
+};
+
+static const char* pattern_name(Pattern pattern) noexcept {
+    switch (pattern) {
+        case Pattern::Sequential: return "seq";
+        case Pattern::Random: return "random";
+        case Pattern::Zipf: return "zipf";
+    }
+    return "?";
+}
+
+static std::vector<std::string> split(std::string_view list, char sep) {
+    std::vector<std::string> out;
+    size_t pos = 0;
+    while (pos <= list.size()) {
+        const size_t end = std::min(list.find(sep, pos), list.size());
+        if (end > pos) out.emplace_back(list.substr(pos, end - pos));
+        pos = end + 1;
+    }
+    return out;
+}
+
+static bool parse_config(const std::string& text, SwapConfig& out) {
+    out = SwapConfig{};
+    out.label = text;
+    std::string rest = text;
+    if (rest.ends_with("@wb")) {
+        out.writeback = true;
+        rest.resize(rest.size() - 3);
+    }
+    if (const auto plus = rest.find('+'); plus != std::string::npos) {
+        out.recompress = rest.substr(plus + 1);
+        rest.resize(plus);
+    }
+    if (const auto colon = rest.find(':'); colon != std::string::npos) {
+        out.level = std::atoi(rest.c_str() + colon + 1);
+        rest.resize(colon);
+    }
+    out.algorithm = rest;
+    return !out.algorithm.empty() && out.level >= 0;
+}
+
+static std::uint64_t next_random(std::uint64_t& state) noexcept {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// Page index sequence for the re-fault pass. Zipf ranks are scattered over the working
+// set by a fixed permutation so the hot pages are not one contiguous run.
+static std::vector<std::uint32_t> make_accesses(Pattern pattern, size_t pages, size_t count, double theta) {
+    std::vector<std::uint32_t> out(count);
+    std::uint64_t state = 0x2545f4914f6cdd1dULL;
+    if (pattern == Pattern::Sequential) {
+        for (size_t i = 0; i < count; ++i) out[i] = static_cast<std::uint32_t>(i % pages);
+    } else if (pattern == Pattern::Random) {
+        for (auto& index : out) index = static_cast<std::uint32_t>(next_random(state) % pages);
+    } else {
+        std::vector<double> cdf(pages);
+        double sum = 0;
+        for (size_t rank = 0; rank < pages; ++rank) {
+            sum += 1.0 / std::pow(static_cast<double>(rank + 1), theta);
+            cdf[rank] = sum;
+        }
+        std::vector<std::uint32_t> placement(pages);
+        std::iota(placement.begin(), placement.end(), 0u);
+        for (size_t i = pages - 1; i > 0; --i) std::swap(placement[i], placement[next_random(state) % (i + 1)]);
+
+        for (auto& index : out) {
+            const double u = static_cast<double>(next_random(state) >> 11) / 9007199254740992.0 * sum;
+            const size_t rank = std::min<size_t>(std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin(), pages - 1);
+            index = placement[rank];
+        }
+    }
+    return out;
+}
+
+// Working set pages currently on swap, from /proc/self/pagemap
+static size_t count_swapped(int pagemap, const char* base, size_t pages) noexcept {
+    std::uint64_t entries[512];
+    size_t swapped = 0;
+    const off_t first = static_cast<off_t>(reinterpret_cast<std::uintptr_t>(base) / kPageSize * sizeof(std::uint64_t));
+    for (size_t done = 0; done < pages;) {
+        const size_t chunk = std::min(pages - done, std::size(entries));
+        const ssize_t got = pread(pagemap, entries, chunk * sizeof(std::uint64_t),
+                                  first + static_cast<off_t>(done * sizeof(std::uint64_t)));
+        if (got <= 0) break;
+        const size_t n = static_cast<size_t>(got) / sizeof(std::uint64_t);
+        for (size_t i = 0; i < n; ++i) swapped += (entries[i] & kPmSwapped) != 0;
+        done += n;
+    }
+    return swapped;
+}
+
+static double to_ms(const timeval& tv) noexcept {
+    return static_cast<double>(tv.tv_sec) * 1000.0 + static_cast<double>(tv.tv_usec) / 1000.0;
+}
+
+// A child memory cgroup whose limit forces the working set out to swap. Works with
+// cgroup v2 and with the v1 hierarchy Android mounts at /dev/memcg.
+class Memcg {
+public:
+    bool create(size_t limit_bytes) {
+        struct Candidate { const char* root; bool v2; };
+        for (const auto& c : {Candidate{"/sys/fs/cgroup", true}, Candidate{"/dev/memcg", false},
+                              Candidate{"/sys/fs/cgroup/memory", false}}) {
+            std::string controllers;
+            if (c.v2 && !(zram::read_sysfs(std::string(c.root) + "/cgroup.controllers", controllers) &&
+                          controllers.find("memory") != std::string::npos)) {
+                continue;
+            }
+            if (!c.v2 && access((std::string(c.root) + "/memory.limit_in_bytes").c_str(), F_OK) != 0) continue;
+
+            root_ = c.root;
+            v2_ = c.v2;
+            if (v2_) zram::write_sysfs(root_ + "/cgroup.subtree_control", "+memory");
+            path_ = root_ + "/swapbench." + std::to_string(getpid());
+            if (mkdir(path_.c_str(), 0755) != 0 && errno != EEXIST) continue;
+
+            const bool limited = v2_
+                ? zram::write_sysfs(path_ + "/memory.max", std::to_string(limit_bytes)) &&
+                  zram::write_sysfs(path_ + "/memory.swap.max", "max")
+                : zram::write_sysfs(path_ + "/memory.limit_in_bytes", std::to_string(limit_bytes));
+            if (!v2_) zram::write_sysfs(path_ + "/memory.swappiness", "100");
+            if (limited) return true;
+            rmdir(path_.c_str());
+        }
+        path_.clear();
+        return false;
+    }
+
+    bool enter() {
+        original_ = current_group();
+        entered_ = zram::write_sysfs(path_ + "/cgroup.procs", std::to_string(getpid()));
+        return entered_;
+    }
+
+    // Back to where we came from, then drop the group. A group we never entered (the
+    // method probe) leaves our membership alone: moving to the root would escape the
+    // cgroup swapbench was started in.
+    void destroy() {
+        if (path_.empty()) return;
+        if (entered_) {
+            const std::string back = original_.empty() ? root_ : original_;
+            zram::write_sysfs(back + "/cgroup.procs", std::to_string(getpid()));
+            entered_ = false;
+        }
+        zram::wait_until([&] { return rmdir(path_.c_str()) == 0 || errno != EBUSY; }, 2000);
+        path_.clear();
+    }
+
+    const std::string& root() const noexcept { return root_; }
+
+private:
+    // Our group in this hierarchy from /proc/self/cgroup ("0::/x" on v2, "N:memory:/x" on v1)
+    std::string current_group() const {
+        FILE* fp = std::fopen("/proc/self/cgroup", "re");
+        if (!fp) return {};
+        char line[512];
+        std::string out;
+        while (out.empty() && std::fgets(line, sizeof(line), fp)) {
+            std::string_view entry{line};
+            if (!entry.empty() && entry.back() == '\n') entry.remove_suffix(1);
+            const auto first = entry.find(':');
+            const auto second = entry.find(':', first + 1);
+            if (first == std::string_view::npos || second == std::string_view::npos) continue;
+            const std::string_view controllers = entry.substr(first + 1, second - first - 1);
+            const bool match = v2_ ? entry.starts_with("0::") : (controllers == "memory" ||
+                               controllers.find("memory,") != std::string_view::npos ||
+                               controllers.ends_with(",memory"));
+            if (match) out = root_ + std::string(entry.substr(second + 1));
+        }
+        std::fclose(fp);
+        return out;
+    }
+
+    std::string root_;
+    std::string path_;
+    std::string original_;
+    bool v2_{false};
+    bool entered_{false};
+};
+
+// Configure, mkswap and swapon the scratch device at the highest priority so the
+// kernel prefers it over any swap already active on the box
+static bool device_up(const Options& opt, const std::string& device, const SwapConfig& config) {
+    if (!zram::reset_device(device, 5000)) {
+        std::fprintf(stderr, "Cannot reset %s (%s)\n", device.c_str(), strerror(errno));
+        return false;
+    }
+
+    std::string selected;
+    zram::write_sysfs(zram::sysfs_path(device, "comp_algorithm"), config.algorithm);
+    zram::read_sysfs(zram::sysfs_path(device, "comp_algorithm"), selected);
+    if (zram::current_algorithm(selected) != config.algorithm) {
+        std::fprintf(stderr, "Algorithm not accepted by the kernel: %s\n", config.algorithm.c_str());
+        return false;
+    }
+    if (config.level > 0 && !zram::set_level(device, config.algorithm, config.level)) {
+        std::fprintf(stderr, "Cannot set level for %s\n", config.label.c_str());
+        return false;
+    }
+    if (!config.recompress.empty() &&
+        !zram::write_sysfs(zram::sysfs_path(device, "recomp_algorithm"), "algo=" + config.recompress + " priority=1")) {
+        std::fprintf(stderr, "Recompression algorithm not accepted: %s (%s)\n", config.recompress.c_str(), strerror(errno));
+        return false;
+    }
+    if (config.writeback && !zram::write_sysfs(zram::sysfs_path(device, "backing_dev"), opt.backing_dev)) {
+        std::fprintf(stderr, "Cannot set backing_dev %s (%s)\n", opt.backing_dev.c_str(), strerror(errno));
+        return false;
+    }
+    // Room for the whole working set plus whatever else the system swaps meanwhile
+    if (!zram::write_sysfs(zram::sysfs_path(device, "disksize"), std::to_string(opt.pages * kPageSize * 2))) {
+        std::fprintf(stderr, "Cannot set disksize of %s (%s)\n", device.c_str(), strerror(errno));
+        return false;
+    }
+    if (!zram::write_swap_signature(device)) return false;
+
+    const std::string dev = zram::block_path(device);
+    if (swapon(dev.c_str(), SWAP_FLAG_PREFER | SWAP_FLAG_PRIO_MASK) != 0) {
+        std::fprintf(stderr, "swapon %s failed (%s)\n", dev.c_str(), strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+static void device_down(const std::string& device) {
+    if (zram::in_proc_swaps(device) && swapoff(zram::block_path(device).c_str()) != 0) {
+        std::fprintf(stderr, "swapoff %s failed (%s)\n", device.c_str(), strerror(errno));
+    }
+    zram::reset_device(device, 5000);
+}
+
+// Optional post-swap-out stages a config asks for: recompress everything idle with the
+// secondary algorithm, or write idle pages back to the backing device
+static void apply_post_stages(const std::string& device, const SwapConfig& config, RunResult& result) {
+    if (config.recompress.empty() && !config.writeback) return;
+    zram::write_sysfs(zram::sysfs_path(device, "idle"), "all");
+
+    if (!config.recompress.empty()) {
+        const auto start = Clock::now();
+        if (zram::write_sysfs(zram::sysfs_path(device, "recompress"), "type=idle")) {
+            result.recompress_ms = elapsed_ms(start);
+        } else {
+            std::fprintf(stderr, "recompress failed on %s (%s)\n", device.c_str(), strerror(errno));
+        }
+        zram::read_mm_stat(device, result.mm_recompressed);
+    }
+    if (config.writeback) {
+        const auto start = Clock::now();
+        if (zram::write_sysfs(zram::sysfs_path(device, "writeback"), "idle")) {
+            result.writeback_ms = elapsed_ms(start);
+        } else {
+            std::fprintf(stderr, "writeback failed on %s (%s)\n", device.c_str(), strerror(errno));
+        }
+        std::string bd;
+        if (zram::read_sysfs(zram::sysfs_path(device, "bd_stat"), bd)) {
+            std::sscanf(bd.c_str(), "%*u %*u %llu", &result.bd_writes);
+        }
+    }
+}
+
+static bool run_one(const Options& opt, const std::string& device, const SwapConfig& config, double entropy,
+                    Pattern pattern, RunResult& result) {
+    result = RunResult{};
+    result.config = config;
+    result.entropy = entropy;
+    result.pattern = pattern;
+
+    // Everything the timed loop needs is allocated before joining the memcg
+    const size_t count = opt.accesses ? opt.accesses : opt.pages;
+    const std::vector<std::uint32_t> order = make_accesses(pattern, opt.pages, count, opt.zipf_theta);
+    std::vector<std::uint32_t> latency_ns;
+    latency_ns.reserve(count);
+    const int pagemap = open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+    if (pagemap < 0) {
+        std::fprintf(stderr, "Cannot open /proc/self/pagemap (%s)\n", strerror(errno));
+        return false;
+    }
+
+    if (!device_up(opt, device, config)) {
+        close(pagemap);
+        device_down(device);
+        return false;
+    }
+
+    Memcg memcg;
+    if (opt.method == Method::Memcg) {
+        const size_t limit = std::max<size_t>(opt.pages * kPageSize * static_cast<size_t>(opt.resident_pct) / 100,
+                                              4 * 1024 * 1024);
+        if (!memcg.create(limit) || !memcg.enter()) {
+            std::fprintf(stderr, "Cannot set up a memory cgroup (%s)\n", strerror(errno));
+            memcg.destroy();
+            close(pagemap);
+            device_down(device);
+            return false;
+        }
+    }
+
+    const size_t bytes = opt.pages * kPageSize;
+    void* raw = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        std::fprintf(stderr, "Cannot map %zu pages (%s)\n", opt.pages, strerror(errno));
+        memcg.destroy();
+        close(pagemap);
+        device_down(device);
+        return false;
+    }
+    std::unique_ptr<char, MapFree> set{static_cast<char*>(raw), MapFree{bytes}};
+    // THP would swap (and time) 512 pages at once
+    madvise(set.get(), bytes, MADV_NOHUGEPAGE);
+
+    // memcg: filling past the limit reclaims into zram as it goes
+    // pageout: fill resident, then ask for the whole range to be reclaimed
+    auto start = Clock::now();
+    zram::fill_synthetic(set.get(), bytes, entropy);
+    if (opt.method == Method::Pageout) {
+        for (int pass = 0; pass < 3; ++pass) {
+            if (madvise(set.get(), bytes, MADV_PAGEOUT) != 0) {
+                std::fprintf(stderr, "MADV_PAGEOUT failed (%s)\n", strerror(errno));
+                break;
+            }
+            if (count_swapped(pagemap, set.get(), opt.pages) * 100 >= opt.pages * 99) break;
+        }
+    }
+    result.push_ms = elapsed_ms(start);
+    result.swapped = count_swapped(pagemap, set.get(), opt.pages);
+    zram::read_mm_stat(device, result.mm);
+    apply_post_stages(device, config, result);
+
+    rusage before{}, after{};
+    getrusage(RUSAGE_SELF, &before);
+    start = Clock::now();
+    const volatile char* base = set.get();
+    unsigned sink = 0;
+    const off_t first = static_cast<off_t>(reinterpret_cast<std::uintptr_t>(set.get()) / kPageSize * sizeof(std::uint64_t));
+    for (const std::uint32_t index : order) {
+        if (g_stop) break;
+        std::uint64_t pme = 0;
+        pread(pagemap, &pme, sizeof(pme), first + static_cast<off_t>(index * sizeof(std::uint64_t)));
+        const auto touch = Clock::now();
+        sink += static_cast<unsigned char>(base[static_cast<size_t>(index) * kPageSize]);
+        if (pme & kPmSwapped) {
+            latency_ns.push_back(static_cast<std::uint32_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - touch).count()));
+        }
+    }
+    result.seconds = elapsed_ms(start) / 1000.0;
+    getrusage(RUSAGE_SELF, &after);
+    (void)sink;
+
+    result.accesses = order.size();
+    result.swapins = latency_ns.size();
+    result.cpu_user_ms = to_ms(after.ru_utime) - to_ms(before.ru_utime);
+    result.cpu_sys_ms = to_ms(after.ru_stime) - to_ms(before.ru_stime);
+    result.major_faults = after.ru_majflt - before.ru_majflt;
+    if (!latency_ns.empty()) {
+        std::sort(latency_ns.begin(), latency_ns.end());
+        const auto at = [&](double q) {
+            return latency_ns[std::min(latency_ns.size() - 1, static_cast<size_t>(q * static_cast<double>(latency_ns.size())))] / 1000.0;
+        };
+        result.p50_us = at(0.5);
+        result.p90_us = at(0.9);
+        result.p99_us = at(0.99);
+        result.p999_us = at(0.999);
+        result.max_us = latency_ns.back() / 1000.0;
+    }
+
+    set.reset();
+    memcg.destroy();
+    close(pagemap);
+    device_down(device);
+    // An interrupted pass is not a result
+    return !g_stop;
+}
+
+static double ratio_of(const zram::MmStat& mm) noexcept {
+    return mm.compr_data_size > 0 ? static_cast<double>(mm.orig_data_size) / static_cast<double>(mm.compr_data_size) : 0;
+}
+
+static void write_mm(FILE* out, const zram::MmStat& mm) {
+    std::fprintf(out, "{\"orig_data_size\": %llu, \"compr_data_size\": %llu, \"mem_used_total\": %llu, "
+                      "\"same_pages\": %llu, \"huge_pages\": %llu, \"ratio\": %.3f}",
+                 mm.orig_data_size, mm.compr_data_size, mm.mem_used_total, mm.same_pages, mm.huge_pages, ratio_of(mm));
+}
+
+static void write_report(FILE* out, const Options& opt, const std::vector<RunResult>& results) {
+    std::fprintf(out, "{\n  \"timestamp\": %ld,\n  \"page_size\": %zu,\n  \"pages\": %zu,\n  \"method\": \"%s\",\n",
+                 static_cast<long>(std::time(nullptr)), kPageSize, opt.pages,
+                 opt.method == Method::Memcg ? "memcg" : "pageout");
+    if (opt.method == Method::Memcg) std::fprintf(out, "  \"resident_pct\": %d,\n", opt.resident_pct);
+    std::fprintf(out, "  \"zipf_theta\": %.2f,\n  \"results\": [\n", opt.zipf_theta);
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        std::fprintf(out, "    {\"config\": \"%s\", \"algorithm\": \"%s\", \"level\": %d, \"recompress\": \"%s\", "
+                          "\"writeback\": %s, \"entropy\": %.2f, \"pattern\": \"%s\",\n",
+                     r.config.label.c_str(), r.config.algorithm.c_str(), r.config.level, r.config.recompress.c_str(),
+                     r.config.writeback ? "true" : "false", r.entropy, pattern_name(r.pattern));
+        std::fprintf(out, "     \"swapped_pages\": %zu, \"push_ms\": %.1f, \"mm_stat\": ", r.swapped, r.push_ms);
+        write_mm(out, r.mm);
+        if (r.recompress_ms >= 0) {
+            std::fprintf(out, ", \"recompress_ms\": %.1f, \"mm_stat_recompressed\": ", r.recompress_ms);
+            write_mm(out, r.mm_recompressed);
+        }
+        if (r.writeback_ms >= 0) {
+            std::fprintf(out, ", \"writeback_ms\": %.1f, \"bd_writes\": %llu", r.writeback_ms, r.bd_writes);
+        }
+        const double swapin_mbps = r.seconds > 0 ? static_cast<double>(r.swapins * kPageSize) / r.seconds / (1024.0 * 1024.0) : 0;
+        std::fprintf(out, ",\n     \"accesses\": %zu, \"swapins\": %zu, \"major_faults\": %ld, \"seconds\": %.3f, "
+                          "\"accesses_per_s\": %.0f, \"swapin_mbps\": %.1f, \"cpu_user_ms\": %.1f, \"cpu_sys_ms\": %.1f,\n"
+                          "     \"swapin_p50_us\": %.2f, \"swapin_p90_us\": %.2f, \"swapin_p99_us\": %.2f, "
+                          "\"swapin_p999_us\": %.2f, \"swapin_max_us\": %.2f}%s\n",
+                     r.accesses, r.swapins, r.major_faults, r.seconds,
+                     r.seconds > 0 ? static_cast<double>(r.accesses) / r.seconds : 0, swapin_mbps,
+                     r.cpu_user_ms, r.cpu_sys_ms, r.p50_us, r.p90_us, r.p99_us, r.p999_us, r.max_us,
+                     i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+}
+
+// Side-by-side view on stderr, grouped by workload so configs compare directly
+static void print_table(const std::vector<RunResult>& results) {
+    std::fprintf(stderr, "\n%-8s %-7s %-20s %7s %8s %9s %9s %9s %9s\n",
+                 "entropy", "pattern", "config", "ratio", "swapins", "p50_us", "p99_us", "MB/s", "sys_ms");
+    std::vector<const RunResult*> sorted;
+    for (const auto& r : results) sorted.push_back(&r);
+    std::stable_sort(sorted.begin(), sorted.end(), [](const RunResult* a, const RunResult* b) {
+        return a->entropy != b->entropy ? a->entropy < b->entropy : a->pattern < b->pattern;
+    });
+    for (const RunResult* r : sorted) {
+        const zram::MmStat& mm = r->recompress_ms >= 0 ? r->mm_recompressed : r->mm;
+        std::fprintf(stderr, "%-8.2f %-7s %-20s %7.2f %8zu %9.2f %9.2f %9.1f %9.1f\n",
+                     r->entropy, pattern_name(r->pattern), r->config.label.c_str(), ratio_of(mm), r->swapins,
+                     r->p50_us, r->p99_us,
+                     r->seconds > 0 ? static_cast<double>(r->swapins * kPageSize) / r->seconds / (1024.0 * 1024.0) : 0,
+                     r->cpu_sys_ms);
+    }
+}
+
+static void print_usage(const char* prog) noexcept {
+    std::printf("Usage: %s [options]\n", prog);
+    std::printf("Options:\n");
+    std::printf("  -d DEV      Idle zram device to use (default: hot_add a scratch device)\n");
+    std::printf("  -c LIST     Configs ALGO[:LEVEL][+RECOMP][@wb], comma separated\n");
+    std::printf("              (default: every algorithm the kernel offers)\n");
+    std::printf("  -e LIST     Data entropies 0..1, comma separated (default: 0.5)\n");
+    std::printf("  -p LIST     Access patterns: seq, random, zipf (default: all three)\n");
+    std::printf("  -m MIB      Working set size (default: 64)\n");
+    std::printf("  -n COUNT    Accesses per re-fault pass (default: one per page)\n");
+    std::printf("  -M METHOD   memcg or pageout (default: memcg, pageout when no memory cgroup)\n");
+    std::printf("  -r PCT      Resident share of the working set under memcg (default: 25)\n");
+    std::printf("  -s THETA    Zipf skew (default: 0.99)\n");
+    std::printf("  -B DEV      Backing device for @wb configs\n");
+    std::printf("  -o FILE     Write the JSON report to FILE (default: stdout)\n");
+    std::printf("  -h          Show help\n");
+}
+
+int main(int argc, char* argv[]) {
+    Options opt;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        if (arg == "-d" && i + 1 < argc) opt.device = argv[++i];
+        else if (arg == "-c" && i + 1 < argc) opt.configs = split(argv[++i], ',');
+        else if (arg == "-e" && i + 1 < argc) {
+            opt.entropies.clear();
+            for (const auto& e : split(argv[++i], ',')) opt.entropies.push_back(std::clamp(std::atof(e.c_str()), 0.0, 1.0));
+        }
+        else if (arg == "-p" && i + 1 < argc) {
+            opt.patterns.clear();
+            for (const auto& p : split(argv[++i], ',')) {
+                if (p == "seq") opt.patterns.push_back(Pattern::Sequential);
+                else if (p == "random") opt.patterns.push_back(Pattern::Random);
+                else if (p == "zipf") opt.patterns.push_back(Pattern::Zipf);
+                else {
+                    std::fprintf(stderr, "Unknown pattern: %s\n", p.c_str());
+                    return 1;
+                }
+            }
+        }
+        else if (arg == "-m" && i + 1 < argc) opt.pages = std::strtoul(argv[++i], nullptr, 10) * 1024 * 1024 / kPageSize;
+        else if (arg == "-n" && i + 1 < argc) opt.accesses = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "-M" && i + 1 < argc) {
+            const std::string_view method{argv[++i]};
+            if (method != "memcg" && method != "pageout") {
+                std::fprintf(stderr, "Unknown method: %s\n", argv[i]);
+                return 1;
+            }
+            opt.method = method == "memcg" ? Method::Memcg : Method::Pageout;
+            opt.method_set = true;
+        }
+        else if (arg == "-r" && i + 1 < argc) opt.resident_pct = std::clamp(std::atoi(argv[++i]), 1, 90);
+        else if (arg == "-s" && i + 1 < argc) opt.zipf_theta = std::atof(argv[++i]);
+        else if (arg == "-B" && i + 1 < argc) opt.backing_dev = argv[++i];
+        else if (arg == "-o" && i + 1 < argc) opt.output = argv[++i];
+        else if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            std::fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (opt.pages < 256) {
+        std::fprintf(stderr, "The working set must be at least 1 MiB\n");
+        return 1;
+    }
+
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+    signal(SIGHUP, signal_handler);
+
+    // Fall back to MADV_PAGEOUT (Linux 5.4+) when there is no memory cgroup to limit
+    if (!opt.method_set) {
+        Memcg probe;
+        if (!probe.create(opt.pages * kPageSize)) opt.method = Method::Pageout;
+        probe.destroy();
+    }
+
+    // Never touch a device that is in use as swap
+    const bool scratch = opt.device.empty();
+    std::string device = scratch ? zram::hot_add() : opt.device;
+    if (device.empty()) {
+        std::fprintf(stderr, "Cannot create a scratch zram device (%s)\n", strerror(errno));
+        return 1;
+    }
+    if (zram::in_proc_swaps(device)) {
+        std::fprintf(stderr, "%s is an active swap device\n", device.c_str());
+        return 1;
+    }
+
+    if (opt.configs.empty()) opt.configs = zram::available_algorithms(device);
+    std::vector<SwapConfig> configs;
+    for (const auto& text : opt.configs) {
+        SwapConfig config;
+        if (!parse_config(text, config)) {
+            std::fprintf(stderr, "Invalid config: %s\n", text.c_str());
+            continue;
+        }
+        if (config.writeback && opt.backing_dev.empty()) {
+            std::fprintf(stderr, "%s needs a backing device (-B)\n", text.c_str());
+            continue;
+        }
+        configs.push_back(std::move(config));
+    }
+
+    // The vendor zstd knob is global, restore it for the live devices afterwards
+    std::string saved_level;
+    const bool restore_level = zram::read_sysfs("/sys/module/zstd/parameters/compression_level", saved_level);
+
+    std::vector<RunResult> results;
+    for (const auto& config : configs) {
+        for (const double entropy : opt.entropies) {
+            for (const Pattern pattern : opt.patterns) {
+                if (g_stop) break;
+                std::fprintf(stderr, "Running %s, entropy %.2f, %s...\n", config.label.c_str(), entropy, pattern_name(pattern));
+                RunResult result;
+                if (run_one(opt, device, config, entropy, pattern, result)) results.push_back(std::move(result));
+            }
+        }
+    }
+
+    if (restore_level) {
+        zram::write_sysfs("/sys/module/zstd/parameters/compression_level", saved_level);
+    }
+    if (scratch) zram::hot_remove(device);
+    if (g_stop) std::fprintf(stderr, "Interrupted, reporting the %zu completed runs\n", results.size());
+
+    print_table(results);
+
+    FILE* out = stdout;
+    std::string tmp_path;
+    if (!opt.output.empty()) {
+        tmp_path = opt.output + ".tmp";
+        out = std::fopen(tmp_path.c_str(), "we");
+        if (!out) {
+            std::fprintf(stderr, "Cannot open: %s (%s)\n", tmp_path.c_str(), strerror(errno));
+            return 1;
+        }
+    }
+    write_report(out, opt, results);
+    if (out != stdout) {
+        std::fclose(out);
+        if (rename(tmp_path.c_str(), opt.output.c_str()) != 0) {
+            std::fprintf(stderr, "Cannot rename: %s (%s)\n", tmp_path.c_str(), strerror(errno));
+            return 1;
+        }
+    }
+    return results.empty() || g_stop ? 1 : 0;
+}
@@ -0,0 +1,322 @@
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+
+// Linux-specific headers
+#include <sys/syscall.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Per-process swap attribution: walks /proc with getdents64 and reads status
+// (optionally smaps_rollup) from a small thread pool, then ranks apps by swap.
+
+using Clock = std::chrono::steady_clock;
+
+struct linux_dirent64 {
+    std::uint64_t d_ino;
+    std::int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+struct ProcSample {
+    int pid{0};
+    unsigned uid{0};
+    long swap_kb{0};
+    long rss_kb{0};
+    long pss_kb{-1};        // smaps_rollup only
+    long swap_pss_kb{-1};   // smaps_rollup only
+    char name[128]{};       // package for apps, comm otherwise
+};
+
+struct AppUsage {
+    unsigned uid{0};
+    std::string name;
+    int processes{0};
+    long swap_kb{0};
+    long rss_kb{0};
+    long pss_kb{0};
+    long swap_pss_kb{0};
+};
+
+struct Options {
+    int top{20};
+    int threads{0};
+    bool smaps{false};
+    bool per_process{false};
+    std::string output;
+};
+
+constexpr unsigned kFirstAppUid = 10000;
+
+// Numeric /proc entries only; getdents64 avoids readdir's per-entry overhead and allocation
+static std::vector<int> list_pids() noexcept {
+    std::vector<int> pids;
+    pids.reserve(512);
+
+    const int fd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) return pids;
+
+    alignas(linux_dirent64) char buf[32768];
+    for (;;) {
+        const long len = syscall(SYS_getdents64, fd, buf, sizeof(buf));
+        if (len <= 0) break;
+        for (long pos = 0; pos < len;) {
+            const auto* entry = reinterpret_cast<const linux_dirent64*>(buf + pos);
+            pos += entry->d_reclen;
+            if (entry->d_type != DT_DIR || entry->d_name[0] < '1' || entry->d_name[0] > '9') continue;
+            pids.push_back(std::atoi(entry->d_name));
+        }
+    }
+    close(fd);
+    return pids;
+}
+
+// Read a whole small procfs file into the caller's reusable buffer
+static ssize_t read_proc_file(const char* path, char* buf, size_t size) noexcept {
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    ssize_t total = 0;
+    while (static_cast<size_t>(total) < size - 1) {
+        const ssize_t len = read(fd, buf + total, size - 1 - total);
+        if (len <= 0) break;
+        total += len;
+    }
+    close(fd);
+    buf[total] = '\0';
+    return total;
+}
+
+// Value of a "Key:   123 kB" line, or -1 when the key is absent
+static long field_kb(std::string_view text, std::string_view key) noexcept {
+    size_t pos = 0;
+    while ((pos = text.find(key, pos)) != std::string_view::npos) {
+        if (pos == 0 || text[pos - 1] == '\n') {
+            return std::strtol(text.data() + pos + key.size(), nullptr, 10);
+        }
+        pos += key.size();
+    }
+    return -1;
+}
+
+static bool sample_process(int pid, char* buf, size_t size, bool smaps, ProcSample& out) noexcept {
+    char path[64];
+    std::snprintf(path, sizeof(path), "/proc/%d/status", pid);
+    const ssize_t len = read_proc_file(path, buf, size);
+    if (len <= 0) return false;
+    const std::string_view status{buf, static_cast<size_t>(len)};
+
+    // Kernel threads have no Vm* lines
+    out.swap_kb = field_kb(status, "VmSwap:");
+    if (out.swap_kb < 0) return false;
+    out.rss_kb = std::max(0L, field_kb(status, "VmRSS:"));
+    out.pid = pid;
+    out.uid = static_cast<unsigned>(std::max(0L, field_kb(status, "Uid:")));
+
+    if (const auto name = status.find("Name:\t"); name != std::string_view::npos) {
+        const auto end = status.find('\n', name);
+        const auto comm = status.substr(name + 6, end - name - 6);
+        const size_t n = std::min(comm.size(), sizeof(out.name) - 1);
+        std::memcpy(out.name, comm.data(), n);
+        out.name[n] = '\0';
+    }
+
+    // App processes are named after their package in cmdline ("pkg" or "pkg:service")
+    if (out.uid >= kFirstAppUid) {
+        std::snprintf(path, sizeof(path), "/proc/%d/cmdline", pid);
+        if (read_proc_file(path, buf, size) > 0 && buf[0] != '\0') {
+            const size_t n = std::min(std::strcspn(buf, ":"), sizeof(out.name) - 1);
+            std::memcpy(out.name, buf, n);
+            out.name[n] = '\0';
+        }
+    }
+
+    if (smaps) {
+        std::snprintf(path, sizeof(path), "/proc/%d/smaps_rollup", pid);
+        const ssize_t rollup_len = read_proc_file(path, buf, size);
+        if (rollup_len > 0) {
+            const std::string_view rollup{buf, static_cast<size_t>(rollup_len)};
+            out.pss_kb = field_kb(rollup, "Pss:");
+            out.swap_pss_kb = field_kb(rollup, "SwapPss:");
+        }
+    }
+    return true;
+}
+
+// Workers pull pids off a shared cursor; each owns one reused read buffer
+static std::vector<ProcSample> scan(const std::vector<int>& pids, int threads, bool smaps) {
+    std::vector<ProcSample> samples(pids.size());
+    std::vector<char> valid(pids.size(), 0);
+    std::atomic<size_t> cursor{0};
+
+    auto worker = [&] {
+        char buf[8192];
+        for (size_t i; (i = cursor.fetch_add(1, std::memory_order_relaxed)) < pids.size();) {
+            valid[i] = sample_process(pids[i], buf, sizeof(buf), smaps, samples[i]);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool) thread.join();
+
+    size_t kept = 0;
+    for (size_t i = 0; i < samples.size(); ++i) {
+        if (valid[i]) samples[kept++] = samples[i];
+    }
+    samples.resize(kept);
+    return samples;
+}
+
+static std::vector<AppUsage> aggregate(const std::vector<ProcSample>& samples) {
+    std::unordered_map<std::string, AppUsage> apps;
+    for (const auto& s : samples) {
+        // System daemons stay separate by name, apps merge every process of the package
+        std::string key = std::to_string(s.uid) + '/' + s.name;
+        auto& app = apps[key];
+        app.uid = s.uid;
+        app.name = s.name;
+        app.processes++;
+        app.swap_kb += s.swap_kb;
+        app.rss_kb += s.rss_kb;
+        app.pss_kb += std::max(0L, s.pss_kb);
+        app.swap_pss_kb += std::max(0L, s.swap_pss_kb);
+    }
+
+    std::vector<AppUsage> out;
+    out.reserve(apps.size());
+    for (auto& [_, app] : apps) out.push_back(std::move(app));
+    return out;
+}
+
+// Names come from cmdline/comm, escape what would break the JSON
+static void print_json_string(FILE* out, std::string_view text) noexcept {
+    std::fputc('"', out);
+    for (const char c : text) {
+        if (c == '"' || c == '\\') std::fprintf(out, "\\%c", c);
+        else if (static_cast<unsigned char>(c) < 0x20) std::fprintf(out, "\\u%04x", c);
+        else std::fputc(c, out);
+    }
+    std::fputc('"', out);
+}
+
+static void write_report(FILE* out, const Options& opt, std::vector<AppUsage>& apps,
+                         std::vector<ProcSample>& samples, double elapsed) {
+    const auto by_swap = [](const auto& a, const auto& b) {
+        return a.swap_kb != b.swap_kb ? a.swap_kb > b.swap_kb : a.rss_kb > b.rss_kb;
+    };
+    std::sort(apps.begin(), apps.end(), by_swap);
+    std::sort(samples.begin(), samples.end(), by_swap);
+
+    long total_swap = 0;
+    for (const auto& s : samples) total_swap += s.swap_kb;
+
+    std::fprintf(out, "{\"elapsed_ms\":%.2f,\"threads\":%d,\"processes\":%zu,\"total_swap_kb\":%ld,\"apps\":[",
+                 elapsed, opt.threads, samples.size(), total_swap);
+    const size_t app_count = std::min(apps.size(), static_cast<size_t>(opt.top));
+    for (size_t i = 0; i < app_count; ++i) {
+        const auto& app = apps[i];
+        std::fprintf(out, "%s{\"uid\":%u,\"name\":", i ? "," : "", app.uid);
+        print_json_string(out, app.name);
+        std::fprintf(out, ",\"processes\":%d,\"swap_kb\":%ld,\"rss_kb\":%ld", app.processes, app.swap_kb, app.rss_kb);
+        if (opt.smaps) std::fprintf(out, ",\"pss_kb\":%ld,\"swap_pss_kb\":%ld", app.pss_kb, app.swap_pss_kb);
+        std::fputc('}', out);
+    }
+    std::fputc(']', out);
+
+    if (opt.per_process) {
+        std::fprintf(out, ",\"processes_top\":[");
+        const size_t proc_count = std::min(samples.size(), static_cast<size_t>(opt.top));
+        for (size_t i = 0; i < proc_count; ++i) {
+            const auto& s = samples[i];
+            std::fprintf(out, "%s{\"pid\":%d,\"uid\":%u,\"name\":", i ? "," : "", s.pid, s.uid);
+            print_json_string(out, s.name);
+            std::fprintf(out, ",\"swap_kb\":%ld,\"rss_kb\":%ld", s.swap_kb, s.rss_kb);
+            if (opt.smaps) std::fprintf(out, ",\"pss_kb\":%ld,\"swap_pss_kb\":%ld", s.pss_kb, s.swap_pss_kb);
+            std::fputc('}', out);
+        }
+        std::fputc(']', out);
+    }
+    std::fprintf(out, "}\n");
+}
+
+static void print_usage(const char* prog) noexcept {
+    std::printf("Usage: %s [options]\n", prog);
+    std::printf("Options:\n");
+    std::printf("  -n TOP     Number of entries to report (default: 20)\n");
+    std::printf("  -j N       Worker threads (default: online CPUs, at most 4)\n");
+    std::printf("  -s         Also read smaps_rollup for Pss/SwapPss (slower)\n");
+    std::printf("  -P         Also list the top processes\n");
+    std::printf("  -o FILE    Write the JSON report to FILE (default: stdout)\n");
+    std::printf("  -h         Show help\n");
+}
+
+int main(int argc, char* argv[]) {
+    Options opt;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        if (arg == "-n" && i + 1 < argc) opt.top = std::atoi(argv[++i]);
+        else if (arg == "-j" && i + 1 < argc) opt.threads = std::atoi(argv[++i]);
+        else if (arg == "-s") opt.smaps = true;
+        else if (arg == "-P") opt.per_process = true;
+        else if (arg == "-o" && i + 1 < argc) opt.output = argv[++i];
+        else if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            std::fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (opt.threads <= 0) {
+        opt.threads = static_cast<int>(std::clamp(sysconf(_SC_NPROCESSORS_ONLN), 1L, 4L));
+    }
+    if (opt.top <= 0) {
+        std::fprintf(stderr, "Invalid option value\n");
+        return 1;
+    }
+
+    const auto start = Clock::now();
+    const auto pids = list_pids();
+    if (pids.empty()) {
+        std::fprintf(stderr, "Cannot list /proc (%s)\n", strerror(errno));
+        return 1;
+    }
+    auto samples = scan(pids, opt.threads, opt.smaps);
+    auto apps = aggregate(samples);
+    const double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    FILE* out = stdout;
+    std::string tmp_path;
+    if (!opt.output.empty()) {
+        tmp_path = opt.output + ".tmp";
+        out = std::fopen(tmp_path.c_str(), "we");
+        if (!out) {
+            std::fprintf(stderr, "Cannot open: %s (%s)\n", tmp_path.c_str(), strerror(errno));
+            return 1;
+        }
+    }
+    write_report(out, opt, apps, samples, elapsed);
+    if (out != stdout) {
+        std::fclose(out);
+        if (rename(tmp_path.c_str(), opt.output.c_str()) != 0) {
+            std::fprintf(stderr, "Cannot rename: %s (%s)\n", tmp_path.c_str(), strerror(errno));
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,266 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+
+// Linux-specific headers
+#include <fcntl.h>
+#include <unistd.h>
+
+// Shared zram sysfs / swap helpers for the native tools
+namespace zram {
+
+using Clock = std::chrono::steady_clock;
+
+// swap_header v1 layout from include/linux/swap.h
+struct SwapHeaderInfo {
+    char bootbits[1024];
+    std::uint32_t version;
+    std::uint32_t last_page;
+    std::uint32_t nr_badpages;
+    unsigned char sws_uuid[16];
+    unsigned char sws_volume[16];
+};
+
+struct SwapEntry {
+    long long size_kb{0};
+    long long used_kb{0};
+    int priority{0};
+};
+
+// First eight fields of /sys/block/zramN/mm_stat
+struct MmStat {
+    unsigned long long orig_data_size{0};
+    unsigned long long compr_data_size{0};
+    unsigned long long mem_used_total{0};
+    unsigned long long mem_limit{0};
+    unsigned long long mem_used_max{0};
+    unsigned long long same_pages{0};
+    unsigned long long pages_compacted{0};
+    unsigned long long huge_pages{0};
+};
+
+inline double elapsed_ms(Clock::time_point since) noexcept {
+    return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+}
+
+inline std::string sysfs_path(std::string_view device, std::string_view attr) {
+    std::string path = "/sys/block/";
+    path += device;
+    path += '/';
+    path += attr;
+    return path;
+}
+
+inline bool read_sysfs(const std::string& path, std::string& out) noexcept {
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    char buf[512];
+    const ssize_t len = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (len < 0) return false;
+    out.assign(buf, static_cast<size_t>(len));
+    while (!out.empty() && (out.back() == '\n' || out.back() == ' ')) out.pop_back();
+    return true;
+}
+
+inline bool write_sysfs(const std::string& path, std::string_view value) noexcept {
+    const int fd = open(path.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    const ssize_t len = write(fd, value.data(), value.size());
+    const int saved = errno;
+    close(fd);
+    errno = saved;
+    return len == static_cast<ssize_t>(value.size());
+}
+
+inline std::string block_path(std::string_view device) {
+    std::string path = "/dev/block/";
+    path += device;
+    if (access(path.c_str(), F_OK) != 0) {
+        path = "/dev/";
+        path += device;
+    }
+    return path;
+}
+
+inline bool is_initialized(std::string_view device) noexcept {
+    std::string state;
+    return read_sysfs(sysfs_path(device, "initstate"), state) && state == "1";
+}
+
+inline bool read_mm_stat(std::string_view device, MmStat& out) noexcept {
+    std::string line;
+    if (!read_sysfs(sysfs_path(device, "mm_stat"), line)) return false;
+    return std::sscanf(line.c_str(), "%llu %llu %llu %llu %llu %llu %llu %llu",
+                       &out.orig_data_size, &out.compr_data_size, &out.mem_used_total, &out.mem_limit,
+                       &out.mem_used_max, &out.same_pages, &out.pages_compacted, &out.huge_pages) >= 7;
+}
+
+// Match /proc/swaps entries by basename so both /dev/block/zramN and /dev/zramN count
+inline bool find_swap_entry(std::string_view device, SwapEntry* out) noexcept {
+    FILE* fp = std::fopen("/proc/swaps", "re");
+    if (!fp) return false;
+
+    char line[512];
+    bool found = false;
+    while (!found && std::fgets(line, sizeof(line), fp)) {
+        std::string_view entry{line};
+        entry = entry.substr(0, entry.find_first_of(" \t"));
+        if (const auto slash = entry.rfind('/'); slash != std::string_view::npos) {
+            entry.remove_prefix(slash + 1);
+        }
+        found = entry == device;
+        if (found && out) {
+            std::sscanf(line, "%*s %*s %lld %lld %d", &out->size_kb, &out->used_kb, &out->priority);
+        }
+    }
+    std::fclose(fp);
+    return found;
+}
+
+inline bool in_proc_swaps(std::string_view device) noexcept {
+    return find_swap_entry(device, nullptr);
+}
+
+// Poll with exponential backoff (1 ms .. 50 ms) instead of fixed sleeps
+template <typename Pred>
+inline bool wait_until(Pred&& ready, int timeout_ms) noexcept {
+    const auto deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+    auto delay = std::chrono::milliseconds(1);
+    while (!ready()) {
+        if (Clock::now() >= deadline) return false;
+        std::this_thread::sleep_for(delay);
+        delay = std::min(delay * 2, std::chrono::milliseconds(50));
+    }
+    return true;
+}
+
+// Selected algorithm is the bracketed entry of comp_algorithm
+inline std::string current_algorithm(const std::string& list) {
+    const auto open = list.find('[');
+    const auto close = list.find(']', open);
+    if (open == std::string::npos || close == std::string::npos) return list;
+    return list.substr(open + 1, close - open - 1);
+}
+
+// Every algorithm the kernel offers for this device, brackets stripped
+inline std::vector<std::string> available_algorithms(std::string_view device) {
+    std::vector<std::string> out;
+    std::string list;
+    if (!read_sysfs(sysfs_path(device, "comp_algorithm"), list)) return out;
+
+    size_t pos = 0;
+    while (pos < list.size()) {
+        const size_t end = std::min(list.find(' ', pos), list.size());
+        std::string name = list.substr(pos, end - pos);
+        name.erase(std::remove_if(name.begin(), name.end(), [](char c) { return c == '[' || c == ']'; }), name.end());
+        if (!name.empty()) out.push_back(std::move(name));
+        pos = end + 1;
+    }
+    return out;
+}
+
+// Per-device algorithm_params (Linux 6.12+) or the vendor zstd module parameter
+inline bool set_level(const std::string& device, std::string_view algorithm, int level) noexcept {
+    const std::string params = sysfs_path(device, "algorithm_params");
+    if (access(params.c_str(), W_OK) == 0) {
+        return write_sysfs(params, "algo=" + std::string(algorithm) + " level=" + std::to_string(level));
+    }
+    return algorithm == "zstd" &&
+           write_sysfs("/sys/module/zstd/parameters/compression_level", std::to_string(level));
+}
+
+inline bool has_level_knob(const std::string& device) noexcept {
+    return access(sysfs_path(device, "algorithm_params").c_str(), W_OK) == 0 ||
+           access("/sys/module/zstd/parameters/compression_level", W_OK) == 0;
+}
+
+// Synthetic page contents: each byte is random with probability `entropy`, otherwise
+// it repeats the previous one, so 0 gives same-filled pages and 1 incompressible ones
+inline void fill_synthetic(char* data, size_t bytes, double entropy, std::uint64_t seed = 0x9e3779b97f4a7c15ULL) noexcept {
+    std::uint64_t state = seed;
+    const auto threshold = static_cast<std::uint32_t>(entropy * 65536.0);
+    char prev = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        if ((state & 0xffff) < threshold) prev = static_cast<char>(state >> 24);
+        data[i] = prev;
+    }
+}
+
+// Reset with EBUSY retries; reset returns EBUSY while the block device is still held open
+inline bool reset_device(std::string_view device, int timeout_ms) noexcept {
+    const std::string reset = sysfs_path(device, "reset");
+    bool written = false;
+    wait_until([&] { written = write_sysfs(reset, "1"); return written || errno != EBUSY; }, timeout_ms);
+    return written && wait_until([&] { return !is_initialized(device); }, timeout_ms);
+}
+
+// Create a new device through zram-control, returns its name or an empty string
+inline std::string hot_add() {
+    std::string id;
+    if (!read_sysfs("/sys/class/zram-control/hot_add", id) || id.empty()) return {};
+    return "zram" + id;
+}
+
+inline bool hot_remove(std::string_view device) noexcept {
+    return device.size() > 4 && write_sysfs("/sys/class/zram-control/hot_remove", device.substr(4));
+}
+
+// Equivalent of mkswap: a zeroed first page with the v1 header and SWAPSPACE2 magic
+inline bool write_swap_signature(std::string_view device) noexcept {
+    std::string disksize;
+    if (!read_sysfs(sysfs_path(device, "disksize"), disksize)) {
+        std::fprintf(stderr, "Cannot read disksize of %.*s (%s)\n",
+                     static_cast<int>(device.size()), device.data(), strerror(errno));
+        return false;
+    }
+
+    const long page_size = sysconf(_SC_PAGESIZE);
+    const std::uint64_t pages = std::strtoull(disksize.c_str(), nullptr, 10) / static_cast<std::uint64_t>(page_size);
+    if (pages < 10) {
+        std::fprintf(stderr, "%.*s is too small for swap: %s bytes\n",
+                     static_cast<int>(device.size()), device.data(), disksize.c_str());
+        return false;
+    }
+
+    std::string page(static_cast<size_t>(page_size), '\0');
+    auto* info = reinterpret_cast<SwapHeaderInfo*>(page.data());
+    info->version = 1;
+    info->last_page = static_cast<std::uint32_t>(std::min<std::uint64_t>(pages - 1, UINT32_MAX));
+    info->nr_badpages = 0;
+    // getrandom() needs API 28, urandom works on every supported release
+    if (const int rnd = open("/dev/urandom", O_RDONLY | O_CLOEXEC); rnd >= 0) {
+        if (read(rnd, info->sws_uuid, sizeof(info->sws_uuid)) != static_cast<ssize_t>(sizeof(info->sws_uuid))) {
+            std::memset(info->sws_uuid, 0, sizeof(info->sws_uuid));
+        }
+        close(rnd);
+    }
+    std::memcpy(page.data() + page_size - 10, "SWAPSPACE2", 10);
+
+    const std::string dev = block_path(device);
+    const int fd = open(dev.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::fprintf(stderr, "Cannot open: %s (%s)\n", dev.c_str(), strerror(errno));
+        return false;
+    }
+    const bool ok = pwrite(fd, page.data(), page.size(), 0) == static_cast<ssize_t>(page.size()) && fsync(fd) == 0;
+    if (!ok) {
+        std::fprintf(stderr, "Failed to write swap header: %s (%s)\n", dev.c_str(), strerror(errno));
+    }
+    close(fd);
+    return ok;
+}
+
+} // namespace zram
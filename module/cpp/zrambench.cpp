@@ -0,0 +1,503 @@
+#include "zram_sysfs.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <ctime>
+#include <csignal>
+
+// Linux-specific headers
+#include <sys/stat.h>
+#include <sched.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Measures the kernel's own zram codecs on this SoC: every candidate algorithm is
+// loaded on a scratch zram device and 4 KiB pages are written/read with O_DIRECT,
+// so compression and decompression run synchronously in the pinned benchmark thread.
+
+using zram::Clock;
+
+constexpr size_t kPageSize = 4096;
+
+// Set on SIGINT/SIGTERM/SIGHUP; the current config is abandoned and the scratch
+// device and zstd level are cleaned up as on a normal exit
+static volatile sig_atomic_t g_stop = 0;
+
+static void signal_handler(int) {
+    g_stop = 1;
+}
+
+struct CoreType {
+    int cpu;            // representative CPU the benchmark pins to
+    long max_freq_khz;
+    int count;
+};
+
+struct BenchConfig {
+    std::string algorithm;
+    int level{0};       // 0 = kernel default
+
+    std::string label() const {
+        return level > 0 ? algorithm + ":" + std::to_string(level) : algorithm;
+    }
+};
+
+struct CoreResult {
+    int cpu;
+    double comp_mbps;
+    double decomp_mbps;
+    double comp_p50_us, comp_p99_us;
+    double decomp_p50_us, decomp_p99_us;
+};
+
+struct BenchResult {
+    BenchConfig config;
+    double ratio{0};
+    unsigned long long mem_used{0};
+    std::vector<CoreResult> cores;
+
+    double worst_decomp_p99() const {
+        double worst = 0;
+        for (const auto& core : cores) worst = std::max(worst, core.decomp_p99_us);
+        return worst;
+    }
+};
+
+struct Options {
+    std::string device;
+    std::string corpus{"proc"};
+    std::string save_corpus;
+    std::string output;
+    std::vector<std::string> algorithms;
+    std::vector<int> levels{1, 3, 9};
+    size_t pages{4096};
+};
+
+struct AlignedFree {
+    void operator()(void* ptr) const noexcept { std::free(ptr); }
+};
+using PageBuffer = std::unique_ptr<char, AlignedFree>;
+
+static std::vector<std::string> split(std::string_view list, char sep) {
+    std::vector<std::string> out;
+    size_t pos = 0;
+    while (pos <= list.size()) {
+        const size_t end = std::min(list.find(sep, pos), list.size());
+        if (end > pos) out.emplace_back(list.substr(pos, end - pos));
+        pos = end + 1;
+    }
+    return out;
+}
+
+// Group CPUs by cpuinfo_max_freq: one representative per core type (little/mid/big)
+static std::vector<CoreType> detect_core_types() {
+    std::map<long, CoreType> types;
+    const long ncpu = sysconf(_SC_NPROCESSORS_CONF);
+    for (int cpu = 0; cpu < ncpu; ++cpu) {
+        std::string freq;
+        const std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/cpuinfo_max_freq";
+        const long khz = zram::read_sysfs(path, freq) ? std::atol(freq.c_str()) : 0;
+        auto [it, inserted] = types.try_emplace(khz, CoreType{cpu, khz, 0});
+        it->second.count++;
+    }
+
+    std::vector<CoreType> out;
+    for (const auto& [_, type] : types) out.push_back(type);
+    if (out.empty()) out.push_back(CoreType{0, 0, 1});
+    return out;
+}
+
+static bool pin_to_cpu(int cpu) noexcept {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+// Sample resident anonymous pages from running processes. pagemap is checked first
+// so swapped-out pages are skipped instead of being faulted back in by the read.
+static size_t sample_process_memory(char* pages, size_t wanted) {
+    size_t got = 0;
+    const pid_t self = getpid();
+
+    DIR* proc = opendir("/proc");
+    if (!proc) return 0;
+
+    // Each pass samples a different page of every 7-page stride, with a bigger per-process quota
+    for (unsigned pass = 0; pass < 7 && got < wanted; ++pass) {
+        const size_t quota = std::max<size_t>(16, wanted / 64) << pass;
+        rewinddir(proc);
+
+        while (got < wanted) {
+            const dirent* entry = readdir(proc);
+            if (!entry) break;
+            const pid_t pid = std::atoi(entry->d_name);
+            if (pid <= 0 || pid == self) continue;
+
+            const std::string base = "/proc/" + std::to_string(pid);
+            FILE* maps = std::fopen((base + "/maps").c_str(), "re");
+            if (!maps) continue;
+            const int pagemap = open((base + "/pagemap").c_str(), O_RDONLY | O_CLOEXEC);
+            const int mem = open((base + "/mem").c_str(), O_RDONLY | O_CLOEXEC);
+
+            size_t taken = 0;
+            char line[512];
+            while (pagemap >= 0 && mem >= 0 && taken < quota && got < wanted && std::fgets(line, sizeof(line), maps)) {
+                unsigned long start = 0, end = 0, inode = 0;
+                char perms[5] = {};
+                if (std::sscanf(line, "%lx-%lx %4s %*s %*s %lu", &start, &end, perms, &inode) != 4) continue;
+                if (perms[0] != 'r' || perms[1] != 'w' || perms[3] != 'p' || inode != 0) continue;
+
+                // Stride through the region so one large heap does not dominate the sample
+                for (unsigned long addr = start + pass * kPageSize; addr < end && taken < quota && got < wanted;
+                     addr += 7 * kPageSize) {
+                    std::uint64_t pme = 0;
+                    if (pread(pagemap, &pme, sizeof(pme), static_cast<off_t>(addr / kPageSize * sizeof(pme))) != sizeof(pme)) break;
+                    const bool present = pme & (1ULL << 63);
+                    const bool swapped = pme & (1ULL << 62);
+                    if (!present || swapped) continue;
+                    if (pread(mem, pages + got * kPageSize, kPageSize, static_cast<off_t>(addr)) != static_cast<ssize_t>(kPageSize)) continue;
+                    ++got;
+                    ++taken;
+                }
+            }
+
+            if (pagemap >= 0) close(pagemap);
+            if (mem >= 0) close(mem);
+            std::fclose(maps);
+        }
+    }
+    closedir(proc);
+    return got;
+}
+
+static size_t load_corpus_file(const std::string& path, char* pages, size_t wanted) noexcept {
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return 0;
+    const ssize_t len = read(fd, pages, wanted * kPageSize);
+    close(fd);
+    return len > 0 ? static_cast<size_t>(len) / kPageSize : 0;
+}
+
+static double percentile_us(std::vector<std::uint32_t>& samples, double pct) noexcept {
+    if (samples.empty()) return 0;
+    const size_t idx = std::min(samples.size() - 1, static_cast<size_t>(pct / 100.0 * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+    return samples[idx] / 1000.0;
+}
+
+static double throughput_mbps(const std::vector<std::uint32_t>& samples) noexcept {
+    double total_ns = 0;
+    for (const auto ns : samples) total_ns += ns;
+    return total_ns > 0 ? samples.size() * kPageSize / (total_ns / 1e9) / (1024.0 * 1024.0) : 0;
+}
+
+static bool run_config(const std::string& device, const BenchConfig& config, const char* corpus, size_t pages,
+                       const std::vector<CoreType>& cores, BenchResult& result) {
+    if (!zram::reset_device(device, 5000)) {
+        std::fprintf(stderr, "Cannot reset %s (%s)\n", device.c_str(), strerror(errno));
+        return false;
+    }
+
+    std::string selected;
+    zram::write_sysfs(zram::sysfs_path(device, "comp_algorithm"), config.algorithm);
+    zram::read_sysfs(zram::sysfs_path(device, "comp_algorithm"), selected);
+    if (zram::current_algorithm(selected) != config.algorithm) {
+        std::fprintf(stderr, "Algorithm not accepted by the kernel: %s\n", config.algorithm.c_str());
+        return false;
+    }
+    if (config.level > 0 && !zram::set_level(device, config.algorithm, config.level)) {
+        std::fprintf(stderr, "Cannot set level for %s\n", config.label().c_str());
+        return false;
+    }
+    if (!zram::write_sysfs(zram::sysfs_path(device, "disksize"), std::to_string(pages * kPageSize * 2))) {
+        std::fprintf(stderr, "Cannot set disksize of %s (%s)\n", device.c_str(), strerror(errno));
+        return false;
+    }
+
+    const std::string dev = zram::block_path(device);
+    const int fd = open(dev.c_str(), O_RDWR | O_DIRECT | O_CLOEXEC);
+    if (fd < 0) {
+        std::fprintf(stderr, "Cannot open: %s (%s)\n", dev.c_str(), strerror(errno));
+        return false;
+    }
+
+    void* raw = nullptr;
+    if (posix_memalign(&raw, kPageSize, kPageSize) != 0) {
+        close(fd);
+        return false;
+    }
+    PageBuffer readback{static_cast<char*>(raw)};
+
+    std::vector<std::uint32_t> comp(pages), decomp(pages);
+    result.config = config;
+    result.cores.clear();
+
+    for (size_t c = 0; c < cores.size() && !g_stop; ++c) {
+        pin_to_cpu(cores[c].cpu);
+
+        for (size_t i = 0; i < pages && !g_stop; ++i) {
+            const auto start = Clock::now();
+            if (pwrite(fd, corpus + i * kPageSize, kPageSize, static_cast<off_t>(i * kPageSize)) != static_cast<ssize_t>(kPageSize)) {
+                std::fprintf(stderr, "Write failed on %s (%s)\n", dev.c_str(), strerror(errno));
+                close(fd);
+                return false;
+            }
+            comp[i] = static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        }
+
+        if (c == 0) {
+            zram::MmStat mm;
+            zram::read_mm_stat(device, mm);
+            result.ratio = mm.compr_data_size > 0 ? static_cast<double>(mm.orig_data_size) / mm.compr_data_size : 0;
+            result.mem_used = mm.mem_used_total;
+        }
+
+        for (size_t i = 0; i < pages && !g_stop; ++i) {
+            const auto start = Clock::now();
+            if (pread(fd, readback.get(), kPageSize, static_cast<off_t>(i * kPageSize)) != static_cast<ssize_t>(kPageSize)) {
+                std::fprintf(stderr, "Read failed on %s (%s)\n", dev.c_str(), strerror(errno));
+                close(fd);
+                return false;
+            }
+            decomp[i] = static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        }
+
+        if (g_stop) break;
+        CoreResult core{};
+        core.cpu = cores[c].cpu;
+        core.comp_mbps = throughput_mbps(comp);
+        core.decomp_mbps = throughput_mbps(decomp);
+        core.comp_p50_us = percentile_us(comp, 50);
+        core.comp_p99_us = percentile_us(comp, 99);
+        core.decomp_p50_us = percentile_us(decomp, 50);
+        core.decomp_p99_us = percentile_us(decomp, 99);
+        result.cores.push_back(core);
+    }
+
+    close(fd);
+    zram::reset_device(device, 5000);
+    // A partly measured config is not a result
+    return !g_stop;
+}
+
+// Among configs whose worst-core decompression p99 is within 1.5x of the fastest,
+// prefer the densest; decompression latency is what the UI thread waits on.
+static size_t pick_recommended(const std::vector<BenchResult>& results) noexcept {
+    double best_latency = 0;
+    for (const auto& r : results) {
+        if (best_latency == 0 || r.worst_decomp_p99() < best_latency) best_latency = r.worst_decomp_p99();
+    }
+    size_t best = 0;
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (results[i].worst_decomp_p99() <= best_latency * 1.5 &&
+            (results[best].worst_decomp_p99() > best_latency * 1.5 || results[i].ratio > results[best].ratio)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+static void write_report(FILE* out, const std::string& corpus_name, size_t pages,
+                         const std::vector<CoreType>& cores, std::vector<BenchResult>& results) {
+    std::sort(results.begin(), results.end(), [](const BenchResult& a, const BenchResult& b) {
+        return a.worst_decomp_p99() < b.worst_decomp_p99();
+    });
+    const size_t recommended = pick_recommended(results);
+
+    std::fprintf(out, "{\n  \"timestamp\": %ld,\n  \"page_size\": %zu,\n  \"pages\": %zu,\n  \"corpus\": \"%s\",\n",
+                 static_cast<long>(std::time(nullptr)), kPageSize, pages, corpus_name.c_str());
+
+    std::fprintf(out, "  \"core_types\": [");
+    for (size_t i = 0; i < cores.size(); ++i) {
+        std::fprintf(out, "%s{\"cpu\": %d, \"max_freq_khz\": %ld, \"count\": %d}",
+                     i ? ", " : "", cores[i].cpu, cores[i].max_freq_khz, cores[i].count);
+    }
+    std::fprintf(out, "],\n");
+
+    std::fprintf(out, "  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        std::fprintf(out, "    {\"rank\": %zu, \"algorithm\": \"%s\", \"level\": %d, \"ratio\": %.3f, \"mem_used\": %llu, "
+                          "\"worst_decomp_p99_us\": %.2f, \"cores\": [",
+                     i + 1, r.config.algorithm.c_str(), r.config.level, r.ratio, r.mem_used, r.worst_decomp_p99());
+        for (size_t c = 0; c < r.cores.size(); ++c) {
+            const auto& core = r.cores[c];
+            std::fprintf(out, "%s{\"cpu\": %d, \"comp_mbps\": %.1f, \"decomp_mbps\": %.1f, "
+                              "\"comp_p50_us\": %.2f, \"comp_p99_us\": %.2f, \"decomp_p50_us\": %.2f, \"decomp_p99_us\": %.2f}",
+                         c ? ", " : "", core.cpu, core.comp_mbps, core.decomp_mbps,
+                         core.comp_p50_us, core.comp_p99_us, core.decomp_p50_us, core.decomp_p99_us);
+        }
+        std::fprintf(out, "]}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out, "  ],\n");
+
+    if (results.empty()) {
+        std::fprintf(out, "  \"recommended\": null\n}\n");
+    } else {
+        std::fprintf(out, "  \"recommended\": {\"algorithm\": \"%s\", \"level\": %d}\n}\n",
+                     results[recommended].config.algorithm.c_str(), results[recommended].config.level);
+    }
+}
+
+static void print_usage(const char* prog) noexcept {
+    std::printf("Usage: %s [options]\n", prog);
+    std::printf("Options:\n");
+    std::printf("  -d DEV     Idle zram device to use (default: hot_add a scratch device)\n");
+    std::printf("  -a LIST    Algorithms, comma separated (default: every algorithm the kernel offers)\n");
+    std::printf("  -z LIST    zstd levels, comma separated (default: 1,3,9 when a level knob exists)\n");
+    std::printf("  -c SRC     Corpus: proc, synthetic[:ENTROPY] or a file of raw pages (default: proc)\n");
+    std::printf("  -S FILE    Save the sampled corpus to FILE\n");
+    std::printf("  -n PAGES   Pages per run (default: 4096)\n");
+    std::printf("  -o FILE    Write the JSON report to FILE (default: stdout)\n");
+    std::printf("  -h         Show help\n");
+}
+
+int main(int argc, char* argv[]) {
+    Options opt;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        if (arg == "-d" && i + 1 < argc) opt.device = argv[++i];
+        else if (arg == "-a" && i + 1 < argc) opt.algorithms = split(argv[++i], ',');
+        else if (arg == "-z" && i + 1 < argc) {
+            opt.levels.clear();
+            for (const auto& level : split(argv[++i], ',')) opt.levels.push_back(std::atoi(level.c_str()));
+        }
+        else if (arg == "-c" && i + 1 < argc) opt.corpus = argv[++i];
+        else if (arg == "-S" && i + 1 < argc) opt.save_corpus = argv[++i];
+        else if (arg == "-n" && i + 1 < argc) opt.pages = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "-o" && i + 1 < argc) opt.output = argv[++i];
+        else if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            std::fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (opt.pages < 64) {
+        std::fprintf(stderr, "At least 64 pages are required\n");
+        return 1;
+    }
+
+    void* raw = nullptr;
+    if (posix_memalign(&raw, kPageSize, opt.pages * kPageSize) != 0) {
+        std::fprintf(stderr, "Cannot allocate corpus of %zu pages\n", opt.pages);
+        return 1;
+    }
+    PageBuffer corpus{static_cast<char*>(raw)};
+
+    std::string corpus_name = opt.corpus;
+    size_t pages = 0;
+    if (opt.corpus == "proc") {
+        pages = sample_process_memory(corpus.get(), opt.pages);
+        if (pages < 64) {
+            std::fprintf(stderr, "Only %zu resident pages sampled, falling back to synthetic:0.5\n", pages);
+            corpus_name = "synthetic:0.5";
+        }
+    } else if (!opt.corpus.starts_with("synthetic")) {
+        pages = load_corpus_file(opt.corpus, corpus.get(), opt.pages);
+    }
+    if (corpus_name.starts_with("synthetic")) {
+        const auto colon = corpus_name.find(':');
+        const double entropy = colon == std::string::npos ? 0.5 : std::atof(corpus_name.c_str() + colon + 1);
+        pages = opt.pages;
+        zram::fill_synthetic(corpus.get(), pages * kPageSize, std::clamp(entropy, 0.0, 1.0));
+    }
+    if (pages < 64) {
+        std::fprintf(stderr, "Corpus too small: %zu pages\n", pages);
+        return 1;
+    }
+
+    if (!opt.save_corpus.empty()) {
+        // Sampled pages are other processes' memory (tokens, keys): owner-only, also
+        // when overwriting a file that already existed with a wider mode
+        const int fd = open(opt.save_corpus.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+        if (fd >= 0) fchmod(fd, 0600);
+        if (fd < 0 || write(fd, corpus.get(), pages * kPageSize) != static_cast<ssize_t>(pages * kPageSize)) {
+            std::fprintf(stderr, "Cannot save corpus: %s (%s)\n", opt.save_corpus.c_str(), strerror(errno));
+        }
+        if (fd >= 0) close(fd);
+    }
+
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+    signal(SIGHUP, signal_handler);
+
+    // Never touch a device that is in use as swap
+    const bool scratch = opt.device.empty();
+    std::string device = scratch ? zram::hot_add() : opt.device;
+    if (device.empty()) {
+        std::fprintf(stderr, "Cannot create a scratch zram device (%s)\n", strerror(errno));
+        return 1;
+    }
+    if (zram::in_proc_swaps(device)) {
+        std::fprintf(stderr, "%s is an active swap device\n", device.c_str());
+        return 1;
+    }
+
+    if (opt.algorithms.empty()) opt.algorithms = zram::available_algorithms(device);
+
+    std::vector<BenchConfig> configs;
+    const bool levels = zram::has_level_knob(device);
+    for (const auto& algo : opt.algorithms) {
+        if (algo == "zstd" && levels) {
+            for (const int level : opt.levels) configs.push_back(BenchConfig{algo, level});
+        } else {
+            configs.push_back(BenchConfig{algo, 0});
+        }
+    }
+
+    // The vendor zstd knob is global, restore it for the live devices afterwards
+    std::string saved_level;
+    const bool restore_level = zram::read_sysfs("/sys/module/zstd/parameters/compression_level", saved_level);
+
+    const auto cores = detect_core_types();
+    std::vector<BenchResult> results;
+    for (const auto& config : configs) {
+        if (g_stop) break;
+        BenchResult result;
+        std::fprintf(stderr, "Benchmarking %s on %zu core type(s)...\n", config.label().c_str(), cores.size());
+        if (run_config(device, config, corpus.get(), pages, cores, result)) {
+            results.push_back(std::move(result));
+        }
+    }
+
+    if (restore_level) {
+        zram::write_sysfs("/sys/module/zstd/parameters/compression_level", saved_level);
+    }
+    zram::reset_device(device, 5000);
+    if (scratch) zram::hot_remove(device);
+    if (g_stop) std::fprintf(stderr, "Interrupted, reporting the %zu completed configs\n", results.size());
+
+    FILE* out = stdout;
+    std::string tmp_path;
+    if (!opt.output.empty()) {
+        tmp_path = opt.output + ".tmp";
+        out = std::fopen(tmp_path.c_str(), "we");
+        if (!out) {
+            std::fprintf(stderr, "Cannot open: %s (%s)\n", tmp_path.c_str(), strerror(errno));
+            return 1;
+        }
+    }
+    write_report(out, corpus_name, pages, cores, results);
+    if (out != stdout) {
+        std::fclose(out);
+        if (rename(tmp_path.c_str(), opt.output.c_str()) != 0) {
+            std::fprintf(stderr, "Cannot rename: %s (%s)\n", tmp_path.c_str(), strerror(errno));
+            return 1;
+        }
+    }
+    return results.empty() || g_stop ? 1 : 0;
+}
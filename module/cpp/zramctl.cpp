@@ -0,0 +1,219 @@
+#include "zram_sysfs.hpp"
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+// Linux-specific headers
+#include <sys/swap.h>
+#include <dirent.h>
+#include <unistd.h>
+
+#ifndef SWAP_FLAG_PREFER
+#define SWAP_FLAG_PREFER 0x8000
+#endif
+#ifndef SWAP_FLAG_PRIO_MASK
+#define SWAP_FLAG_PRIO_MASK 0x7fff
+#endif
+
+using zram::Clock;
+using zram::elapsed_ms;
+
+struct Options {
+    std::string device{"zram0"};
+    int priority{32758};
+    int wait_ms{0};
+    int timeout_ms{5000};
+};
+
+static void report(const Options& opt, const char* phase, double ms) noexcept {
+    std::printf("%s %s %.1f ms\n", opt.device.c_str(), phase, ms);
+    std::fflush(stdout);
+}
+
+static int zram_off(const Options& opt) noexcept {
+    const auto total = Clock::now();
+    const std::string dev = zram::block_path(opt.device);
+
+    // initstate=1 without a /proc/swaps entry means someone (init's swapon_all) is mid-activation
+    if (opt.wait_ms > 0 && !zram::in_proc_swaps(opt.device) && zram::is_initialized(opt.device)) {
+        const auto start = Clock::now();
+        zram::wait_until([&] { return zram::in_proc_swaps(opt.device); }, opt.wait_ms);
+        report(opt, "settle", elapsed_ms(start));
+    }
+
+    if (zram::in_proc_swaps(opt.device)) {
+        const auto start = Clock::now();
+        if (swapoff(dev.c_str()) != 0 && errno != EINVAL) {
+            std::fprintf(stderr, "swapoff %s failed (%s)\n", dev.c_str(), strerror(errno));
+            return 1;
+        }
+        if (!zram::wait_until([&] { return !zram::in_proc_swaps(opt.device); }, opt.timeout_ms)) {
+            std::fprintf(stderr, "%s still listed in /proc/swaps\n", dev.c_str());
+            return 1;
+        }
+        report(opt, "swapoff", elapsed_ms(start));
+    }
+
+    const auto start = Clock::now();
+    if (!zram::reset_device(opt.device, opt.timeout_ms)) {
+        std::fprintf(stderr, "Cannot reset %s (%s)\n", opt.device.c_str(), strerror(errno));
+        return 1;
+    }
+    report(opt, "reset", elapsed_ms(start));
+    report(opt, "off", elapsed_ms(total));
+    return 0;
+}
+
+static int zram_on(const Options& opt) noexcept {
+    const auto total = Clock::now();
+    const std::string dev = zram::block_path(opt.device);
+
+    if (zram::in_proc_swaps(opt.device)) {
+        std::fprintf(stderr, "%s is already an active swap device\n", dev.c_str());
+        return 1;
+    }
+    if (!zram::wait_until([&] { return zram::is_initialized(opt.device); }, opt.timeout_ms)) {
+        std::fprintf(stderr, "%s is not initialized (disksize not set)\n", opt.device.c_str());
+        return 1;
+    }
+
+    auto start = Clock::now();
+    if (!zram::write_swap_signature(opt.device)) {
+        return 1;
+    }
+    report(opt, "mkswap", elapsed_ms(start));
+
+    start = Clock::now();
+    const int flags = SWAP_FLAG_PREFER | (opt.priority & SWAP_FLAG_PRIO_MASK);
+    if (swapon(dev.c_str(), flags) != 0) {
+        std::fprintf(stderr, "swapon %s failed (%s)\n", dev.c_str(), strerror(errno));
+        return 1;
+    }
+    if (!zram::wait_until([&] { return zram::in_proc_swaps(opt.device); }, opt.timeout_ms)) {
+        std::fprintf(stderr, "%s did not appear in /proc/swaps\n", dev.c_str());
+        return 1;
+    }
+    report(opt, "swapon", elapsed_ms(start));
+    report(opt, "on", elapsed_ms(total));
+    return 0;
+}
+
+// Create the device through zram-control when it does not exist yet
+static int zram_add(const Options& opt) noexcept {
+    const std::string dir = "/sys/block/" + opt.device;
+    for (int tries = 0; access(dir.c_str(), F_OK) != 0; ++tries) {
+        if (tries >= 32 || zram::hot_add().empty()) {
+            std::fprintf(stderr, "Cannot create %s (%s)\n", opt.device.c_str(), strerror(errno));
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int zram_remove(const Options& opt) noexcept {
+    if (access(("/sys/block/" + opt.device).c_str(), F_OK) != 0) {
+        return 0;
+    }
+    if (!zram::hot_remove(opt.device)) {
+        std::fprintf(stderr, "Cannot remove %s (%s)\n", opt.device.c_str(), strerror(errno));
+        return 1;
+    }
+    return 0;
+}
+
+static int zram_stats() noexcept {
+    std::vector<int> ids;
+    if (DIR* dir = opendir("/sys/block")) {
+        while (dirent* entry = readdir(dir)) {
+            const std::string_view name{entry->d_name};
+            if (name.starts_with("zram") && name.size() > 4) {
+                ids.push_back(std::atoi(entry->d_name + 4));
+            }
+        }
+        closedir(dir);
+    }
+    std::sort(ids.begin(), ids.end());
+
+    std::printf("[");
+    for (size_t i = 0; i < ids.size(); ++i) {
+        const std::string device = "zram" + std::to_string(ids[i]);
+
+        std::string disksize, algorithms, backing;
+        zram::read_sysfs(zram::sysfs_path(device, "disksize"), disksize);
+        zram::read_sysfs(zram::sysfs_path(device, "comp_algorithm"), algorithms);
+        if (!zram::read_sysfs(zram::sysfs_path(device, "backing_dev"), backing)) backing = "none";
+
+        zram::MmStat mm;
+        zram::read_mm_stat(device, mm);
+
+        zram::SwapEntry swap;
+        const bool active = zram::find_swap_entry(device, &swap);
+
+        std::printf("%s{\"name\":\"%s\",\"disksize\":%llu,\"algorithm\":\"%s\",\"backing_dev\":\"%s\","
+                    "\"orig_data_size\":%llu,\"compr_data_size\":%llu,\"mem_used_total\":%llu,"
+                    "\"mem_used_max\":%llu,\"same_pages\":%llu,\"huge_pages\":%llu,"
+                    "\"swap\":%s,\"priority\":%d,\"swap_used\":%lld}",
+                    i ? "," : "", device.c_str(), std::strtoull(disksize.c_str(), nullptr, 10),
+                    zram::current_algorithm(algorithms).c_str(), backing.c_str(),
+                    mm.orig_data_size, mm.compr_data_size, mm.mem_used_total,
+                    mm.mem_used_max, mm.same_pages, mm.huge_pages,
+                    active ? "true" : "false", swap.priority, swap.used_kb * 1024);
+    }
+    std::printf("]\n");
+    return 0;
+}
+
+static void print_usage(const char* prog) noexcept {
+    std::printf("Usage: %s [options] <command> [device]\n", prog);
+    std::printf("Commands:\n");
+    std::printf("  off          swapoff and reset the device\n");
+    std::printf("  on           write the swap signature and swapon the device\n");
+    std::printf("  add          create the device through zram-control if missing\n");
+    std::printf("  remove       hot-remove the device\n");
+    std::printf("  stats        print every zram device as a JSON array\n");
+    std::printf("Options:\n");
+    std::printf("  -p PRIO      Swap priority for 'on' (default: 32758)\n");
+    std::printf("  -w MS        Wait up to MS for a pending activation before 'off' (default: 0)\n");
+    std::printf("  -t MS        Timeout for each sysfs state transition (default: 5000)\n");
+    std::printf("  -h           Show help\n");
+    std::printf("\nDevice defaults to zram0. Each phase prints '<device> <phase> <ms> ms'.\n");
+}
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    std::string_view command;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        if (arg == "-p" && i + 1 < argc) opt.priority = std::atoi(argv[++i]);
+        else if (arg == "-w" && i + 1 < argc) opt.wait_ms = std::atoi(argv[++i]);
+        else if (arg == "-t" && i + 1 < argc) opt.timeout_ms = std::atoi(argv[++i]);
+        else if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (command.empty()) {
+            command = arg;
+        } else {
+            opt.device = arg.substr(arg.rfind('/') + 1);
+        }
+    }
+
+    if (opt.priority < 0 || opt.priority > SWAP_FLAG_PRIO_MASK || opt.wait_ms < 0 || opt.timeout_ms <= 0) {
+        std::fprintf(stderr, "Invalid option value\n");
+        return 1;
+    }
+
+    if (command == "off") return zram_off(opt);
+    if (command == "on") return zram_on(opt);
+    if (command == "add") return zram_add(opt);
+    if (command == "remove") return zram_remove(opt);
+    if (command == "stats") return zram_stats();
+
+    print_usage(argv[0]);
+    return 1;
+}
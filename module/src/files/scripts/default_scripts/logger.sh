@@ -10,8 +10,12 @@ LOGGER_INITIALIZED=0
 LOG_FILE_NAME="main"
 LOGMONITOR_PID=""
 LOGMONITOR_BIN="${MODPATH}/bin/logmonitor-zram"
+AURORAD_BIN="${MODPATH}/bin/aurorad-zram"
+AURORAD_SOCK="${MODPATH}/files/data/aurorad.sock"
+AURORAD_RUNNING=0  # aurorad 运行时由它负责刷新，不再启动 logmonitor 守护进程
 LOG_LEVEL=3  # 1=ERROR, 2=WARN, 3=INFO, 4=DEBUG
 LOW_POWER_MODE=0  # Default: Low power mode off
+LOG_STATS_FILE=""  # 非空时每次写日志把计数累加到该文件，用 logmonitor -c stats -S 文件 查看
 
 # ============================
 # Core Functions
@@ -22,7 +26,11 @@ init_logger() {
     [ "$LOGGER_INITIALIZED" = "1" ] && return 0
     LOG_DIR="${MODPATH}/logs"
     mkdir -p "$LOG_DIR" 2>/dev/null
-    if [ -f "$LOGMONITOR_BIN" ]; then
+    # aurorad 已托管后台任务时不再启动 logmonitor 守护进程
+    # 只看 socket 文件不够：aurorad 异常退出后会留下旧的 socket，先确认它能应答
+    if [ -S "$AURORAD_SOCK" ] && [ -x "$AURORAD_BIN" ] && "$AURORAD_BIN" -s "$AURORAD_SOCK" ping >/dev/null 2>&1; then
+        AURORAD_RUNNING=1
+    elif [ -f "$LOGMONITOR_BIN" ]; then
         LOGMONITOR_PID=$(pgrep -f "^$LOGMONITOR_BIN.*daemon" 2>/dev/null)
         if [ -z "$LOGMONITOR_PID" ]; then
             if [ "$LOW_POWER_MODE" = "1" ]; then
@@ -49,10 +57,12 @@ log() {
     [ -z "$message" ] && return 1
     [ "$level" -gt "$LOG_LEVEL" ] && return 0
     [ "$LOGGER_INITIALIZED" != "1" ] && init_logger
+    # 即使 aurorad 在运行也直接用 logmonitor 写：每行一个 aurorad 客户端（连接、请求、等待应答）
+    # 实测比一次 logmonitor -c write 慢约一倍
     if [ "$LOW_POWER_MODE" = "1" ]; then
-        "$LOGMONITOR_BIN" -c write -n "$LOG_FILE_NAME" -m "$message" -l "$level" -p
+        "$LOGMONITOR_BIN" -c write -d "$LOG_DIR" -n "$LOG_FILE_NAME" -m "$message" -l "$level" -p ${LOG_STATS_FILE:+-S "$LOG_STATS_FILE"}
     else
-        "$LOGMONITOR_BIN" -c write -n "$LOG_FILE_NAME" -m "$message" -l "$level"
+        "$LOGMONITOR_BIN" -c write -d "$LOG_DIR" -n "$LOG_FILE_NAME" -m "$message" -l "$level" ${LOG_STATS_FILE:+-S "$LOG_STATS_FILE"}
     fi
 }
 
@@ -68,9 +78,9 @@ batch_log() {
     [ ! -f "$batch_file" ] && return 1
     [ "$LOGGER_INITIALIZED" != "1" ] && init_logger
     if [ "$LOW_POWER_MODE" = "1" ]; then
-        "$LOGMONITOR_BIN" -c batch -n "$LOG_FILE_NAME" -b "$batch_file" -p
+        "$LOGMONITOR_BIN" -c batch -d "$LOG_DIR" -n "$LOG_FILE_NAME" -b "$batch_file" -p ${LOG_STATS_FILE:+-S "$LOG_STATS_FILE"}
     else
-        "$LOGMONITOR_BIN" -c batch -n "$LOG_FILE_NAME" -b "$batch_file"
+        "$LOGMONITOR_BIN" -c batch -d "$LOG_DIR" -n "$LOG_FILE_NAME" -b "$batch_file" ${LOG_STATS_FILE:+-S "$LOG_STATS_FILE"}
     fi
     return $?
 }
@@ -104,18 +114,23 @@ set_low_power_mode() {
 
 # Flush logs
 flush_logs() {
-    [ "$LOGGER_INITIALIZED" = "1" ] && "$LOGMONITOR_BIN" -c flush
+    [ "$LOGGER_INITIALIZED" = "1" ] || return 0
+    if [ "$AURORAD_RUNNING" = "1" ]; then
+        "$AURORAD_BIN" -s "$AURORAD_SOCK" flush >/dev/null 2>&1
+    else
+        "$LOGMONITOR_BIN" -c flush -d "$LOG_DIR"
+    fi
 }
 
 # Clean logs
 clean_logs() {
-    [ "$LOGGER_INITIALIZED" = "1" ] && "$LOGMONITOR_BIN" -c clean
+    [ "$LOGGER_INITIALIZED" = "1" ] && "$LOGMONITOR_BIN" -c clean -d "$LOG_DIR"
 }
 
 # Stop logger system
 stop_logger() {
     if [ "$LOGGER_INITIALIZED" = "1" ] && [ -n "$LOGMONITOR_PID" ]; then
-        "$LOGMONITOR_BIN" -c flush
+        "$LOGMONITOR_BIN" -c flush -d "$LOG_DIR"
         sleep 0.5
         kill -TERM "$LOGMONITOR_PID" 2>/dev/null
         wait "$LOGMONITOR_PID" 2>/dev/null
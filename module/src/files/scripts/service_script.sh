@@ -8,12 +8,6 @@ monitor_config() {
     return $?
 }
 
-if [ "$size" = "auto" ]; then
-    chmod 777 -R "$MODPATH/files/scripts/zram_pressure_log.sh"
-    log_info "开始监控zram占用"
-    sh $MODPATH/files/scripts/zram_pressure_log.sh "$MODPATH/files/data" &
-fi
-
 # 加载zran脚本
 if [ ! -f "$MODPATH/files/scripts/zram.sh" ]; then
     log_error "${SERVICE_FILE_NOT_FOUND:-文件未找到}: $MODPATH/files/scripts/zram.sh"
@@ -24,13 +18,67 @@ else
     . "$MODPATH/files/scripts/zram.sh"
 fi
 
+AURORAD_BIN="$MODPATH/bin/aurorad-zram"
+
+# aurorad 在一个进程内托管日志、配置监控、压力采样和调速器，替代下面的脚本循环
+if [ -x "$AURORAD_BIN" ]; then
+    log_info "交由 aurorad 托管后台任务"
+    aurorad_args="-m $MODPATH -l ${LOG_LEVEL:-3}"
+    [ "$LOW_POWER_MODE" = "1" ] && aurorad_args="$aurorad_args -p"
+    stop_logger
+    exec "$AURORAD_BIN" $aurorad_args daemon
+fi
+
+if [ "$size" = "auto" ]; then
+    chmod 777 -R "$MODPATH/files/scripts/zram_pressure_log.sh"
+    log_info "开始监控zram占用"
+    sh $MODPATH/files/scripts/zram_pressure_log.sh "$MODPATH/files/data" &
+fi
+
+GOVERNOR_BIN="$MODPATH/bin/governor-zram"
+
+# 函数：停止 PSI 调速器，等待它把 swappiness、zstd 等级等恢复为启动时的值
+stop_governor() {
+    if pgrep -f "^$GOVERNOR_BIN" >/dev/null 2>&1; then
+        pkill -TERM -f "^$GOVERNOR_BIN"
+        # 等待旧进程写回原始参数
+        local tries=0
+        while pgrep -f "^$GOVERNOR_BIN" >/dev/null 2>&1 && [ "$tries" -lt 50 ]; do
+            sleep 0.1
+            tries=$((tries + 1))
+        done
+    fi
+}
+
+# 函数：按配置启动 PSI 调速器
+start_governor() {
+    [ "$governor_enabled" = "true" ] || return 0
+    if [ ! -x "$GOVERNOR_BIN" ]; then
+        log_warn "${SERVICE_FILE_NOT_FOUND:-文件未找到}: $GOVERNOR_BIN"
+        return 1
+    fi
+    log_info "启动 PSI 调速器"
+    "$GOVERNOR_BIN" -i "${governor_interval:-10}" \
+        -s "${governor_swappiness_min:-60}:${governor_swappiness_max:-100}" \
+        -w "${governor_watermark_min:-10}:${governor_watermark_max:-100}" \
+        -z "${governor_zstd_level_min:-1}:${governor_zstd_level_max:-9}" \
+        -L "${governor_psi_low:-1}:${governor_psi_high:-10}" \
+        -d "$MODPATH/logs" >/dev/null 2>&1 &
+}
+
+stop_governor
+start_governor
+
 while true; do
     set_log_file "service_custom"
     monitor_config
     if [ "$?" = "0" ]; then
         log_info "配置文件改动,重新设置zram"
+        # 先停止调速器：它退出时恢复的是旧值，放在重新配置之后会覆盖新的 zstd 等级
+        stop_governor
         reload_config
-        zram_setup
+        zram_reconfigure
+        start_governor
     else
         Aurora_abort "检测进程异常退出"
     fi
@@ -114,7 +114,7 @@ set_and_verify_algorithm() {
     echo "$cmd" > "$sys_path"
 
     if [ "$algo" = "zstd" ] && [ "$support_zstd_level" = 1 ]; then
-        echo "$zstd_compression_level" > /sys/module/zstd/parameters/compression_level || log_warn "设置zstd压缩等级失败"
+        echo "$(effective_value zstd_compression_level)" > /sys/module/zstd/parameters/compression_level || log_warn "设置zstd压缩等级失败"
     fi
 
     # 验证当前算法
@@ -137,178 +137,513 @@ set_and_verify_algorithm() {
     return 0
 }
 
+# 原生 zram 控制工具（轮询状态代替固定 sleep）
+ZRAMCTL_BIN="$MODPATH/bin/zramctl-zram"
+
+# 函数：运行 zramctl 并记录每个阶段的耗时
+run_zramctl() {
+    local output
+    output=$("$ZRAMCTL_BIN" "$@" 2>&1)
+    local ret=$?
+    echo "$output" | while read -r line; do
+        [ -n "$line" ] && log_info "zramctl: $line"
+    done
+    return $ret
+}
+
+# 函数：读取第 N 个 zram 设备的参数（zram0 沿用原有参数名，zramN 使用 zramN_* 参数）
+zram_device_params() {
+    local i="$1"
+    dev_name="zram$i"
+    if [ "$i" = 0 ]; then
+        dev_algorithm="$algorithm"
+        dev_size="$size"
+        dev_writeback="${writeback_block_size:-0}"
+        dev_priority="${swap_priority:-32758}"
+        dev_file="$FILE"
+    else
+        eval "dev_algorithm=\${zram${i}_algorithm:-\$algorithm}"
+        eval "dev_size=\${zram${i}_size:-\$size}"
+        eval "dev_writeback=\${zram${i}_writeback_block_size:-0}"
+        eval "dev_priority=\${zram${i}_priority:-$((100 - i))}"
+        dev_file="${FILE}_zram$i"
+    fi
+    if [ "$dev_algorithm" = "auto" ]; then
+        resolve_auto_algorithm
+    fi
+}
+
+# 函数：algorithm=auto 时使用 zrambench 报告中推荐的算法（无报告时回退到 lz4）
+BENCH_REPORT="$MODPATH/files/data/zram_bench.json"
+bench_recommendation() {
+    sed -n 's/.*"recommended": {"algorithm": "\([^"]*\)", "level": \([0-9]*\)}.*/\1 \2/p' "$BENCH_REPORT" 2>/dev/null
+}
+
+resolve_auto_algorithm() {
+    local recommended
+    recommended=$(bench_recommendation)
+    if [ -z "$recommended" ]; then
+        log_warn "$dev_name: 没有压缩算法测试报告，auto 回退到 lz4"
+        dev_algorithm="lz4"
+        return
+    fi
+    dev_algorithm="${recommended%% *}"
+    log_info "$dev_name: auto 使用测试推荐的算法 $dev_algorithm (等级 ${recommended##* })"
+}
+
+# 函数：参数的实际生效值
+# algorithm=auto 解析为推荐算法；zstd 等级是全局参数，有设备 auto 选中 zstd 时使用推荐等级
+effective_value() {
+    local value recommended
+    eval "value=\$$1"
+    case "$1" in
+    algorithm|zram*_algorithm)
+        # zramN 未单独配置时沿用 algorithm
+        [ -n "$value" ] || value="$algorithm"
+        if [ "$value" = "auto" ]; then
+            recommended=$(bench_recommendation)
+            value="${recommended%% *}"
+            [ -n "$value" ] || value="lz4"
+        fi
+        ;;
+    zstd_compression_level)
+        recommended=$(bench_recommendation)
+        if [ "${recommended%% *}" = "zstd" ] && [ "${recommended##* }" -gt 0 ] && zram_uses_auto; then
+            value="${recommended##* }"
+        fi
+        ;;
+    esac
+    echo "$value"
+}
+
+# 函数：是否有设备配置为 algorithm=auto
+zram_uses_auto() {
+    local i=0 value
+    while [ "$i" -lt "${zram_devices:-1}" ]; do
+        if [ "$i" = 0 ]; then
+            value="$algorithm"
+        else
+            eval "value=\${zram${i}_algorithm:-\$algorithm}"
+        fi
+        [ "$value" = "auto" ] && return 0
+        i=$((i + 1))
+    done
+    return 1
+}
+
+# 函数：是否有设备（含次级算法）使用 zstd
+zram_uses_zstd() {
+    local i=0 key
+    while [ "$i" -lt "${zram_devices:-1}" ]; do
+        if [ "$i" = 0 ]; then key="algorithm"; else key="zram${i}_algorithm"; fi
+        [ "$(effective_value "$key")" = "zstd" ] && return 0
+        i=$((i + 1))
+    done
+    for key in $ZRAM_RESET_KEYS; do
+        eval "[ \"\$$key\" = zstd ]" && return 0
+    done
+    return 1
+}
+
+# 函数：第 N 个设备参与增量规划的参数名
+zram_device_keys() {
+    if [ "$1" = 0 ]; then
+        echo "algorithm size writeback_block_size swap_priority"
+    else
+        echo "zram$1_algorithm zram$1_size zram$1_writeback_block_size zram$1_priority"
+    fi
+}
+
 zramoff() {
-    log_info "关闭 swap 并重置 zram0"
+    local dev="$1"
+    log_info "关闭 swap 并重置 $dev"
+    if [ -x "$ZRAMCTL_BIN" ]; then
+        # 若 init 仍在激活该设备，最多等待 15 秒
+        run_zramctl -w 15000 off "$dev" && return 0
+        log_warn "zramctl 关闭 $dev 失败，回退到 shell 流程"
+    fi
     sleep 15  # 等待系统稳定
-    su -c swapoff /dev/block/zram0
+    su -c swapoff "/dev/block/$dev"
     sleep 2 # 确保zram已关闭
-    echo 1 > /sys/block/zram0/reset
-    echo 0 > /sys/block/zram0/disksize
+    echo 1 > "/sys/block/$dev/reset"
+    echo 0 > "/sys/block/$dev/disksize"
 }
 
 zramon() {
+    local dev="$1"
+    local priority="$2"
+    if [ -x "$ZRAMCTL_BIN" ]; then
+        log_info "创建并启用 $dev swap，优先级为 $priority"
+        run_zramctl -p "$priority" on "$dev" && return 0
+        log_warn "zramctl 启用 $dev 失败，回退到 shell 流程"
+    fi
     log_info "创建 swap 分区"
-    su -c mkswap /dev/block/zram0
-    log_info "启用 swap，优先级为 32758"
-    su -c swapon -p32758 /dev/block/zram0
+    su -c mkswap "/dev/block/$dev"
+    log_info "启用 swap，优先级为 $priority"
+    su -c swapon -p"$priority" "/dev/block/$dev"
 }
 
-zram_setup() { 
-    # 设置日志文件名
-    set_log_file "zram"
-    # 主逻辑开始
-    log_info "开始设置zram"
+# 函数：确保 zram 设备存在（zram0 以外的设备通过 hot_add 创建）
+zram_add_device() {
+    local dev="$1"
+    [ -d "/sys/block/$dev" ] && return 0
+    if [ -x "$ZRAMCTL_BIN" ]; then
+        run_zramctl add "$dev"
+    else
+        while [ ! -d "/sys/block/$dev" ]; do
+            cat /sys/class/zram-control/hot_add >/dev/null || return 1
+        done
+    fi
+}
 
-    pressure=$(cat "$MODPATH/files/data/average_pressure.conf")
-    loop_edit=0
+# 函数：关闭并移除不再使用的设备
+zram_remove_device() {
+    local dev="$1"
+    [ -d "/sys/block/$dev" ] || return 0
+    zramoff "$dev"
+    if [ -x "$ZRAMCTL_BIN" ]; then
+        run_zramctl remove "$dev"
+    else
+        echo "${dev#zram}" > /sys/class/zram-control/hot_remove
+    fi
+}
 
-    # 关闭并重置zram0
-    zramoff
+# 函数：为设备准备回写文件并绑定 backing_dev
+# 参数1: 设备名  参数2: 回写文件  参数3: 大小（GB）
+zram_setup_writeback() {
+    local dev="$1"
+    local file="$2"
+    local block_size="$3"
 
-    # 设置主压缩算法
-    set_and_verify_algorithm "primary" "$algorithm" "" "/sys/block/zram0/comp_algorithm"
+    # 处理writeback文件
+    log_info "检查并处理文件: $file"
+    check_and_delete_file "$file" "$block_size"
 
-    # 设置次级压缩算法（如果支持）
-    if [ "$support_multi_comp" = "CONFIG_ZRAM_MULTI_COMP=y" ]; then
-        echo true > "$MODPATH/files/data/feature/support_zram_recompressd"
-        for i in 1 2 3; do
-            eval "algo=\$recompressd_algorithm$i"
-            set_and_verify_algorithm "recomp" "$algo" "$i" "/sys/block/zram0/recomp_algorithm"
-        done
-    else
-        log_warn "内核不支持多压缩，跳过次级算法设置"
-        echo false > "$MODPATH/files/data/feature/support_zram_recompressd"
+    if [ "$block_size" -eq 0 ]; then
+        log_warn "$dev 回写大小为 0，跳过处理。"
+        return 0
     fi
 
-    # 处理writeback文件
-    log_info "检查并处理文件: $FILE"
-    check_and_delete_file "$FILE" "$writeback_block_size"
-
-    if [ "$writeback_block_size" -ne 0 ]; then
-        # 文件创建与 Pinning 流程
-        if [ ! -f "$FILE" ]; then
-            log_info "创建大小为 ${writeback_block_size}G 的文件: $FILE"
-            
-            # 确保父目录存在
-            mkdir -p "$(dirname "$FILE")"
-            
-            # TRIM 释放空间，防止分配到脏块
-            $MODPATH/bin/fstrim-zram -v "$(dirname "$FILE")" 2>/dev/null
-            
-            # 先创建空文件
-            touch "$FILE"
-
-            # 在文件为空时设置 Pinning
-            $MODPATH/bin/f2fs_pin-zram 1 "$FILE"
-            if [ $? -ne 0 ]; then
-                log_error "F2FS Pin 设置失败，可能不支持或文件系统错误"
-                rm -f "$FILE" # 失败了要清理，避免留下未 Pin 的文件
-                return 1
-            fi
-            
-            # 预分配
-            # 因为已经设置了 Pin 标志，fallocate 会自动在 Pinned Section 寻找连续空间
-            $MODPATH/bin/fallocate-zram -l "${writeback_block_size}G" "$FILE"
-            if [ $? -ne 0 ]; then
-                log_error "fallocate 失败，空间不足？"
-                rm -f "$FILE" # 分配失败则清理文件
-                return 1
-            fi
+    # 文件创建与 Pinning 流程
+    if [ ! -f "$file" ]; then
+        log_info "创建大小为 ${block_size}G 的文件: $file"
+
+        # 确保父目录存在
+        mkdir -p "$(dirname "$file")"
 
-            # 设置 SELinux 上下文
-            chcon u:object_r:writeback_file:s0 "$FILE"
+        # TRIM 释放空间，防止分配到脏块
+        $MODPATH/bin/fstrim-zram -v "$(dirname "$file")" 2>/dev/null
+
+        # 先创建空文件
+        touch "$file"
+
+        # 在文件为空时设置 Pinning
+        $MODPATH/bin/f2fs_pin-zram 1 "$file"
+        if [ $? -ne 0 ]; then
+            log_error "F2FS Pin 设置失败，可能不支持或文件系统错误"
+            rm -f "$file" # 失败了要清理，避免留下未 Pin 的文件
+            return 1
         fi
 
-        # 智能检查 Loop 设备绑定状态
-        # 使用 losetup -j 查找该文件是否已经绑定了 Loop 设备
-        EXISTING_LOOP=$($MODPATH/bin/losetup-zram -j "$FILE" | head -n1 | cut -d: -f1)
-
-        if [ -n "$EXISTING_LOOP" ]; then
-            log_info "检测到文件已绑定到: $EXISTING_LOOP"
-
-            # 检查是否开启了 Direct IO
-            DIO_STATUS=$($MODPATH/bin/losetup-zram -a | grep "$EXISTING_LOOP" | grep "direct-io")
-            if [ -z "$DIO_STATUS" ]; then
-                 log_warn "现有 Loop 未开启 Direct IO，尝试重新绑定..."
-                 $MODPATH/bin/losetup-zram -d "$EXISTING_LOOP"
-                 EXISTING_LOOP=""
-            else
-                 LOOP_DEVICE="$EXISTING_LOOP"
-            fi
+        # 预分配
+        # 因为已经设置了 Pin 标志，fallocate 会自动在 Pinned Section 寻找连续空间
+        $MODPATH/bin/fallocate-zram -l "${block_size}G" "$file"
+        if [ $? -ne 0 ]; then
+            log_error "fallocate 失败，空间不足？"
+            rm -f "$file" # 分配失败则清理文件
+            return 1
         fi
 
-        # 如果没有绑定，则执行绑定
-        if [ -z "$EXISTING_LOOP" ]; then
-            log_info "正在绑定文件到 loop 设备..."
-            LOOP_DEVICE=$($MODPATH/bin/losetup-zram --direct-io=on --show -f "$FILE")
+        # 设置 SELinux 上下文
+        chcon u:object_r:writeback_file:s0 "$file"
+    fi
 
-            if [ -z "$LOOP_DEVICE" ]; then
-                log_error "Loop 设备绑定失败！"
-                return 1
-            fi
-        fi
+    # 智能检查 Loop 设备绑定状态
+    # 使用 losetup -j 查找该文件是否已经绑定了 Loop 设备
+    local existing_loop loop_device dio_status current_backing
+    existing_loop=$($MODPATH/bin/losetup-zram -j "$file" | head -n1 | cut -d: -f1)
 
-        # 设置 ZRAM backing device
-        CURRENT_BACKING=$(cat /sys/block/zram0/backing_dev)
+    if [ -n "$existing_loop" ]; then
+        log_info "检测到文件已绑定到: $existing_loop"
 
-        if [ "$CURRENT_BACKING" == "none" ]; then
-            log_info "将 $LOOP_DEVICE 设为 zram0 后端..."
-            echo "$LOOP_DEVICE" > /sys/block/zram0/backing_dev
-            if [ $? -eq 0 ]; then
-                log_info "Writeback 设置成功！"
-            else
-                log_error "写入 backing_dev 失败，ZRAM 可能已被占用。"
-            fi
-        elif [ "$CURRENT_BACKING" == "$LOOP_DEVICE" ]; then
-            log_info "ZRAM 已经正确配置了该后端设备。"
+        # 检查是否开启了 Direct IO
+        dio_status=$($MODPATH/bin/losetup-zram -a | grep "$existing_loop" | grep "direct-io")
+        if [ -z "$dio_status" ]; then
+            log_warn "现有 Loop 未开启 Direct IO，尝试重新绑定..."
+            $MODPATH/bin/losetup-zram -d "$existing_loop"
+            existing_loop=""
         else
-            log_warn "ZRAM 已有其他后端设备: $CURRENT_BACKING，跳过设置。"
+            loop_device="$existing_loop"
         fi
+    fi
 
-    else
-        log_warn "writeback_block_size 为 0，跳过处理。"
+    # 如果没有绑定，则执行绑定
+    if [ -z "$existing_loop" ]; then
+        log_info "正在绑定文件到 loop 设备..."
+        loop_device=$($MODPATH/bin/losetup-zram --direct-io=on --show -f "$file")
+
+        if [ -z "$loop_device" ]; then
+            log_error "Loop 设备绑定失败！"
+            return 1
+        fi
     fi
 
-    # 设置disksize
-    if [ "$support_auto_size" = "CONFIG_ZRAM_AUTO_SIZE=y" ]; then
-        echo true > "$MODPATH/files/data/feature/support_auto_size"
+    # 设置 ZRAM backing device
+    current_backing=$(cat "/sys/block/$dev/backing_dev")
+
+    if [ "$current_backing" == "none" ]; then
+        log_info "将 $loop_device 设为 $dev 后端..."
+        echo "$loop_device" > "/sys/block/$dev/backing_dev"
+        if [ $? -eq 0 ]; then
+            log_info "Writeback 设置成功！"
+        else
+            log_error "写入 backing_dev 失败，ZRAM 可能已被占用。"
+        fi
+    elif [ "$current_backing" == "$loop_device" ]; then
+        log_info "$dev 已经正确配置了该后端设备。"
     else
-        echo false > "$MODPATH/files/data/feature/support_auto_size"
+        log_warn "$dev 已有其他后端设备: $current_backing，跳过设置。"
     fi
+}
 
-    if [ "$size" = "auto" ]; then
-        echo "$pressure" > /sys/block/zram0/pressure || log_warn "设置pressure失败"
+# 函数：设置设备 disksize
+zram_setup_disksize() {
+    local dev="$1"
+    local dev_size="$2"
+
+    if [ "$dev_size" = "auto" ]; then
+        echo "$pressure" > "/sys/block/$dev/pressure" || log_warn "设置pressure失败"
         if [ "$support_auto_size" = "CONFIG_ZRAM_AUTO_SIZE=y" ]; then
-            log_info "设置 zram0 磁盘大小为 auto"
-            if ! echo "$size" > /sys/block/zram0/disksize; then
+            log_info "设置 $dev 磁盘大小为 auto"
+            if ! echo "$dev_size" > "/sys/block/$dev/disksize"; then
                 log_error "设置disksize为auto失败,尝试设置为17179869184"
-                if ! echo 17179869184 > /sys/block/zram0/disksize; then
+                if ! echo 17179869184 > "/sys/block/$dev/disksize"; then
                     log_error "设置disksize失败"
                     return 1
                 fi
             fi
         else
             log_warn "不支持自动大小，设置默认 17179869184"
-            if ! echo 17179869184 > /sys/block/zram0/disksize; then
+            if ! echo 17179869184 > "/sys/block/$dev/disksize"; then
                 log_error "设置disksize失败"
                 return 1
             fi
         fi
     else
-        log_info "设置 zram0 磁盘大小为 $size"
-        if ! echo "$size" > /sys/block/zram0/disksize; then
+        log_info "设置 $dev 磁盘大小为 $dev_size"
+        if ! echo "$dev_size" > "/sys/block/$dev/disksize"; then
             log_error "设置disksize失败"
             return 1
         fi
     fi
+}
+
+# 函数：完整设置第 N 个 zram 设备
+zram_setup_device() {
+    zram_device_params "$1"
+    log_info "设置 $dev_name: 算法 $dev_algorithm, 大小 $dev_size, 回写 ${dev_writeback}G, 优先级 $dev_priority"
+
+    zram_add_device "$dev_name" || {
+        log_error "无法创建 $dev_name"
+        return 1
+    }
+
+    # 关闭并重置设备
+    zramoff "$dev_name"
+
+    # 设置主压缩算法
+    set_and_verify_algorithm "primary" "$dev_algorithm" "" "/sys/block/$dev_name/comp_algorithm"
+
+    # 设置次级压缩算法（如果支持）
+    if [ "$support_multi_comp" = "CONFIG_ZRAM_MULTI_COMP=y" ]; then
+        local prio
+        for prio in 1 2 3; do
+            eval "algo=\$recompressd_algorithm$prio"
+            set_and_verify_algorithm "recomp" "$algo" "$prio" "/sys/block/$dev_name/recomp_algorithm"
+        done
+    fi
+
+    zram_setup_writeback "$dev_name" "$dev_file" "$dev_writeback" || return 1
+
+    zram_setup_disksize "$dev_name" "$dev_size" || return 1
 
     # 创建并启用swap
-    zramon
+    zramon "$dev_name" "$dev_priority"
+}
+
+# 配置只提供 zram0（algorithm 等）和 zram1（zram1_*）的参数，更多设备会静默沿用全局参数
+ZRAM_MAX_DEVICES=2
+
+# 函数：把 zram_devices 限制在 1..ZRAM_MAX_DEVICES
+clamp_zram_devices() {
+    case "${zram_devices:-1}" in
+    1|2) ;;
+    *)
+        log_warn "zram_devices=$zram_devices 无效，只支持 1 到 $ZRAM_MAX_DEVICES 个设备，使用 $ZRAM_MAX_DEVICES"
+        zram_devices=$ZRAM_MAX_DEVICES
+        ;;
+    esac
 }
 
-while [ ! -d /data/user/0/android ]; do
-    sleep 1
-done
+zram_setup() { 
+    # 设置日志文件名
+    set_log_file "zram"
+    clamp_zram_devices
+    # 主逻辑开始
+    log_info "开始设置zram (${zram_devices:-1} 个设备)"
 
-zram_setup
+    pressure=$(cat "$MODPATH/files/data/average_pressure.conf")
+    loop_edit=0
 
+    if [ "$support_multi_comp" = "CONFIG_ZRAM_MULTI_COMP=y" ]; then
+        echo true > "$MODPATH/files/data/feature/support_zram_recompressd"
+    else
+        log_warn "内核不支持多压缩，跳过次级算法设置"
+        echo false > "$MODPATH/files/data/feature/support_zram_recompressd"
+    fi
+
+    if [ "$support_auto_size" = "CONFIG_ZRAM_AUTO_SIZE=y" ]; then
+        echo true > "$MODPATH/files/data/feature/support_auto_size"
+    else
+        echo false > "$MODPATH/files/data/feature/support_auto_size"
+    fi
+
+    zram_remove_unused
+
+    local i=0
+    while [ "$i" -lt "${zram_devices:-1}" ]; do
+        zram_setup_device "$i" || return 1
+        i=$((i + 1))
+    done
+
+    save_applied_config
+}
+
+# 已生效配置快照，用于增量重新配置
+APPLIED_CONF="$MODPATH/files/data/zram_applied.conf"
+# 影响所有设备、需要 swapoff + reset 才能修改的参数
+# （内核在设备初始化后拒绝写入 comp_algorithm/recomp_algorithm/backing_dev/disksize）
+ZRAM_RESET_KEYS="recompressd_algorithm1 recompressd_algorithm2 recompressd_algorithm3"
+# 可在线修改的参数
+ZRAM_LIVE_KEYS="zstd_compression_level"
+
+# 函数：记录当前已生效的配置（auto 记录解析后的算法和等级，测试推荐变化时才能检测到）
+save_applied_config() {
+    local key value i=0 keys="zram_devices $ZRAM_RESET_KEYS $ZRAM_LIVE_KEYS"
+    while [ "$i" -lt "${zram_devices:-1}" ]; do
+        keys="$keys $(zram_device_keys "$i")"
+        i=$((i + 1))
+    done
+    : > "$APPLIED_CONF"
+    for key in $keys; do
+        value=$(effective_value "$key")
+        echo "$key=$value" >> "$APPLIED_CONF"
+    done
+}
+
+# 函数：读取快照中的参数值
+applied_value() {
+    sed -n "s/^$1=//p" "$APPLIED_CONF" 2>/dev/null
+}
+
+# 函数：返回第一个与快照不同的参数名
+changed_key() {
+    local key value
+    for key in "$@"; do
+        value=$(effective_value "$key")
+        if [ "$value" != "$(applied_value "$key")" ]; then
+            echo "$key"
+            return 0
+        fi
+    done
+    return 1
+}
+
+# 函数：移除上次设置但已不再配置的设备
+zram_remove_unused() {
+    local i="${zram_devices:-1}"
+    local old_count=$(applied_value zram_devices)
+    while [ "$i" -lt "${old_count:-0}" ]; do
+        log_info "移除不再使用的设备 zram$i"
+        zram_remove_device "zram$i"
+        i=$((i + 1))
+    done
+}
+
+# 函数：在线应用单个参数
+apply_live_key() {
+    case "$1" in
+    zstd_compression_level)
+        # 与 set_and_verify_algorithm 一致，只在有设备使用 zstd 时写入
+        if [ "$support_zstd_level" = 1 ] && zram_uses_zstd; then
+            echo "$(effective_value zstd_compression_level)" > /sys/module/zstd/parameters/compression_level || log_warn "设置zstd压缩等级失败"
+        fi
+        ;;
+    esac
+}
+
+# 函数：对比快照与新配置，只重置参数发生变化的设备
+zram_reconfigure() {
+    set_log_file "zram"
+    clamp_zram_devices
+    local key i old_count changed=""
+
+    if [ ! -f "$APPLIED_CONF" ] || ! grep -q "zram0" /proc/swaps; then
+        log_info "没有已生效的配置快照，执行完整设置"
+        zram_setup
+        return $?
+    fi
+
+    if key=$(changed_key $ZRAM_RESET_KEYS); then
+        log_info "$key: $(applied_value "$key") -> $(effective_value "$key")，需要重置所有设备"
+        zram_setup
+        return $?
+    fi
+
+    pressure=$(cat "$MODPATH/files/data/average_pressure.conf")
+    old_count=$(applied_value zram_devices)
+    [ "${old_count:-1}" != "${zram_devices:-1}" ] && changed="zram_devices"
+    zram_remove_unused
+    i=0
+    while [ "$i" -lt "${zram_devices:-1}" ]; do
+        if [ "$i" -ge "${old_count:-1}" ]; then
+            log_info "新增设备 zram$i"
+            zram_setup_device "$i" || return 1
+            changed="$changed zram$i"
+        elif key=$(changed_key $(zram_device_keys "$i")); then
+            log_info "$key: $(applied_value "$key") -> $(effective_value "$key")，需要重置 zram$i"
+            zram_setup_device "$i" || return 1
+            changed="$changed zram$i"
+        elif [ -f "/sys/block/zram$i/pressure" ]; then
+            # pressure 由采样脚本持续更新，每次都在线写入
+            zram_device_params "$i"
+            if [ "$dev_size" = "auto" ]; then
+                echo "$pressure" > "/sys/block/zram$i/pressure" || log_warn "设置pressure失败"
+            fi
+        fi
+        i=$((i + 1))
+    done
+
+    for key in $ZRAM_LIVE_KEYS; do
+        if [ "$(changed_key "$key")" = "$key" ]; then
+            log_info "$key: $(applied_value "$key") -> $(effective_value "$key")，在线应用"
+            apply_live_key "$key"
+            changed="$changed $key"
+        fi
+    done
+
+    if [ -z "$changed" ]; then
+        log_info "zram 配置无变化，跳过重置"
+    fi
+    save_applied_config
+    return 0
+}
+
+# 仅加载函数（zram_reload.sh）时不执行开机初始化
+if [ -z "$ZRAM_FUNCTIONS_ONLY" ]; then
+    while [ ! -d /data/user/0/android ]; do
+        sleep 1
+    done
+
+    zram_setup
+fi
@@ -0,0 +1,13 @@
+#!/system/bin/sh
+# 由 aurorad 在 config.sh 变化后调用：重新读取配置并在线调整 zram
+MODPATH="${1:-${0%/*/*/*}}"
+
+. "$MODPATH/files/scripts/default_scripts/main.sh"
+start_script
+set_log_file "service_custom"
+
+log_info "配置文件改动,重新设置zram"
+
+ZRAM_FUNCTIONS_ONLY=1
+. "$MODPATH/files/scripts/zram.sh"
+zram_reconfigure
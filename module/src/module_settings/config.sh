@@ -15,3 +15,19 @@ algorithm=lz4k_oplus
 recompressd_algorithm1=zstd
 recompressd_algorithm2=
 recompressd_algorithm3=
+swap_priority=32758
+zram_devices=1
+zram1_algorithm=zstd
+zram1_size=4294967296
+zram1_writeback_block_size=0
+zram1_priority=100
+governor_enabled=false
+governor_interval=10
+governor_swappiness_min=60
+governor_swappiness_max=100
+governor_watermark_min=10
+governor_watermark_max=100
+governor_zstd_level_min=1
+governor_zstd_level_max=9
+governor_psi_low=1
+governor_psi_high=10
@@ -8,6 +8,10 @@ const StatusPage = {
     moduleStatus: 'UNKNOWN',
     refreshTimer: null,
     deviceInfo: {},
+    zramDevices: [],
+    benchReport: null,
+    swapUsage: null,
+    benchRunning: false,
 
     // 版本信息
     currentVersion: '20240503',
@@ -173,16 +177,22 @@ const StatusPage = {
                 this.loadModuleInfo(),
                 this.loadDeviceInfo(),
                 this.getLogCount(),
-                this.getLatestVersion()
+                this.getLatestVersion(),
+                this.loadZramDevices(),
+                this.loadBenchReport(),
+                this.loadSwapUsage()
             ];
 
-            const [moduleInfo, deviceInfo, logCount, latestVersion] = await Promise.allSettled(tasks);
+            const [moduleInfo, deviceInfo, logCount, latestVersion, zramDevices, benchReport, swapUsage] = await Promise.allSettled(tasks);
 
             return {
                 moduleInfo: moduleInfo.value || {},
                 deviceInfo: deviceInfo.value || {},
                 logCount: logCount.value || 0,
-                latestVersion: latestVersion.value
+                latestVersion: latestVersion.value,
+                zramDevices: zramDevices.value || [],
+                benchReport: benchReport.value || null,
+                swapUsage: swapUsage.value || null
             };
         } catch (error) {
             console.warn('预加载数据失败:', error);
@@ -206,12 +216,18 @@ const StatusPage = {
                 this.deviceInfo = preloadedData.deviceInfo;
                 this.logCount = preloadedData.logCount;
                 this.latestVersion = preloadedData.latestVersion;
+                this.zramDevices = preloadedData.zramDevices;
+                this.benchReport = preloadedData.benchReport;
+                this.swapUsage = preloadedData.swapUsage;
                 this.version = this.moduleInfo.version || 'Unknown';
             } else {
                 // 如果没有预加载数据，则正常加载
                 await this.loadModuleInfo();
                 await this.loadDeviceInfo();
                 await this.getLogCount();
+                await this.loadZramDevices();
+                await this.loadBenchReport();
+                await this.loadSwapUsage();
             }
 
             await this.loadModuleStatus(); // 实时状态始终需要加载
@@ -288,6 +304,12 @@ const StatusPage = {
                 icon: 'play_arrow',
                 title: I18n.translate('RUN_ACTION', '运行Action'),
                 onClick: 'runAction'
+            },
+            {
+                id: 'run-benchmark',
+                icon: 'speed',
+                title: I18n.translate('RUN_BENCHMARK', '测试压缩算法'),
+                onClick: 'runBenchmark'
             }
         ]);
     },
@@ -317,6 +339,22 @@ const StatusPage = {
                 </div>
             </div>
             
+            <!-- zram 设备卡片 -->
+            <div class="status-card zram-devices-card">
+                ${this.renderZramDevices()}
+            </div>
+
+            <!-- 各应用 swap 占用卡片 -->
+            <div class="status-card swap-usage-card">
+                ${this.renderSwapUsage()}
+            </div>
+
+            <!-- 压缩算法测试结果卡片 -->
+            ${this.benchReport ? `
+            <div class="status-card zram-bench-card">
+                ${this.renderBenchReport()}
+            </div>` : ''}
+
             <!-- 设备信息卡片 -->
             <div class="status-card device-info-card">
                 <div class="device-info-grid">
@@ -331,13 +369,19 @@ const StatusPage = {
         try {
             const oldStatus = this.moduleStatus;
             const oldDeviceInfo = JSON.stringify(this.deviceInfo);
+            const oldZramDevices = JSON.stringify(this.zramDevices);
+            const oldSwapApps = JSON.stringify(this.swapUsage?.apps);
 
             await this.loadModuleStatus();
             await this.loadDeviceInfo();
+            await this.loadZramDevices();
+            await this.loadSwapUsage();
 
             // 只在状态发生变化时更新UI
             const newDeviceInfo = JSON.stringify(this.deviceInfo);
-            if (oldStatus !== this.moduleStatus || oldDeviceInfo !== newDeviceInfo) {
+            const newZramDevices = JSON.stringify(this.zramDevices);
+            const newSwapApps = JSON.stringify(this.swapUsage?.apps);
+            if (oldStatus !== this.moduleStatus || oldDeviceInfo !== newDeviceInfo || oldZramDevices !== newZramDevices || oldSwapApps !== newSwapApps) {
                 // 更新UI
                 const statusPage = document.querySelector('.status-page');
                 if (statusPage) {
@@ -510,6 +554,173 @@ const StatusPage = {
         }
     },
 
+    // 通过 zramctl 读取所有 zram 设备的状态
+    async loadZramDevices() {
+        try {
+            const result = await Core.execCommand(`${Core.MODULE_PATH}bin/zramctl-zram stats`);
+            this.zramDevices = JSON.parse(result.trim() || '[]');
+        } catch (error) {
+            console.error('获取zram设备状态失败:', error);
+            this.zramDevices = [];
+        }
+        return this.zramDevices;
+    },
+
+    // 进程名、sysfs 和测试报告里的字符串可被其他应用控制，插入 innerHTML 前必须转义
+    escapeHtml(text) {
+        if (text === undefined || text === null) return '';
+        return String(text)
+            .replace(/&/g, "&amp;")
+            .replace(/</g, "&lt;")
+            .replace(/>/g, "&gt;")
+            .replace(/"/g, "&quot;")
+            .replace(/'/g, "&#039;");
+    },
+
+    formatBytes(bytes) {
+        if (!bytes) return '0 B';
+        const units = ['B', 'KB', 'MB', 'GB', 'TB'];
+        const exp = Math.min(Math.floor(Math.log(bytes) / Math.log(1024)), units.length - 1);
+        return `${(bytes / Math.pow(1024, exp)).toFixed(exp ? 1 : 0)} ${units[exp]}`;
+    },
+
+    // 渲染 zram 设备列表
+    renderZramDevices() {
+        if (!this.zramDevices || this.zramDevices.length === 0) {
+            return `<div class="no-info" data-i18n="NO_ZRAM_DEVICES">${I18n.translate('NO_ZRAM_DEVICES', '无zram设备')}</div>`;
+        }
+
+        return `
+            <div class="zram-devices-header">${I18n.translate('ZRAM_DEVICES', 'zram设备')}</div>
+            <div class="device-info-grid">
+                ${this.zramDevices.map(dev => {
+                    const ratio = dev.compr_data_size > 0 ? (dev.orig_data_size / dev.compr_data_size).toFixed(2) : '-';
+                    const swapInfo = dev.swap
+                        ? `${I18n.translate('ZRAM_SWAP_PRIORITY', '交换优先级')} ${this.escapeHtml(dev.priority)} · ${this.formatBytes(dev.swap_used)}`
+                        : I18n.translate('ZRAM_INACTIVE', '未启用');
+                    return `
+                        <div class="device-info-item">
+                            <div class="device-info-icon">
+                                <span class="material-symbols-rounded">${dev.swap ? 'memory' : 'memory_alt'}</span>
+                            </div>
+                            <div class="device-info-content">
+                                <div class="device-info-label">${this.escapeHtml(dev.name)} · ${this.escapeHtml(dev.algorithm)} · ${this.formatBytes(dev.disksize)}</div>
+                                <div class="device-info-value">${swapInfo}</div>
+                                <div class="device-info-value">${I18n.translate('ZRAM_COMPRESSION', '压缩')}: ${this.formatBytes(dev.orig_data_size)} → ${this.formatBytes(dev.compr_data_size)} (${ratio}x)</div>
+                                ${dev.backing_dev !== 'none' ? `<div class="device-info-value">${I18n.translate('ZRAM_BACKING_DEV', '回写设备')}: ${this.escapeHtml(dev.backing_dev)}</div>` : ''}
+                            </div>
+                        </div>
+                    `;
+                }).join('')}
+            </div>
+        `;
+    },
+
+    // 通过 swapscan 统计各应用的 swap 占用
+    async loadSwapUsage() {
+        try {
+            const result = await Core.execCommand(`${Core.MODULE_PATH}bin/swapscan-zram -n 10`);
+            this.swapUsage = JSON.parse(result.trim() || 'null');
+        } catch (error) {
+            console.error('获取应用swap占用失败:', error);
+            this.swapUsage = null;
+        }
+        return this.swapUsage;
+    },
+
+    // 渲染 swap 占用最多的应用
+    renderSwapUsage() {
+        const apps = (this.swapUsage?.apps || []).filter(app => app.swap_kb > 0);
+        if (apps.length === 0) {
+            return `<div class="no-info" data-i18n="NO_SWAP_USAGE">${I18n.translate('NO_SWAP_USAGE', '暂无应用使用swap')}</div>`;
+        }
+
+        return `
+            <div class="zram-devices-header">${I18n.translate('SWAP_TOP_APPS', 'swap占用最多的应用')} · ${this.formatBytes(this.swapUsage.total_swap_kb * 1024)}</div>
+            <div class="device-info-grid">
+                ${apps.map(app => `
+                    <div class="device-info-item">
+                        <div class="device-info-icon">
+                            <span class="material-symbols-rounded">${app.uid >= 10000 ? 'apps' : 'settings'}</span>
+                        </div>
+                        <div class="device-info-content">
+                            <div class="device-info-label">${this.escapeHtml(app.name)}</div>
+                            <div class="device-info-value">${I18n.translate('SWAP_USED', 'swap')}: ${this.formatBytes(app.swap_kb * 1024)} · RSS ${this.formatBytes(app.rss_kb * 1024)}${app.processes > 1 ? ` · ${app.processes} ${I18n.translate('SWAP_PROCESSES', '个进程')}` : ''}</div>
+                        </div>
+                    </div>
+                `).join('')}
+            </div>
+        `;
+    },
+
+    // 读取 zrambench 生成的测试报告
+    async loadBenchReport() {
+        try {
+            const result = await Core.execCommand(`cat "${Core.MODULE_PATH}files/data/zram_bench.json" 2>/dev/null`);
+            this.benchReport = result.trim() ? JSON.parse(result) : null;
+        } catch (error) {
+            console.error('读取压缩测试报告失败:', error);
+            this.benchReport = null;
+        }
+        return this.benchReport;
+    },
+
+    // 在本机内核的压缩算法上运行测试（临时 zram 设备，不影响正在使用的 swap）
+    async runBenchmark() {
+        if (this.benchRunning) return;
+        this.benchRunning = true;
+        try {
+            Core.showToast(I18n.translate('BENCHMARK_RUNNING', '正在测试压缩算法...'));
+            await Core.execCommand(`${Core.MODULE_PATH}bin/zrambench-zram -o "${Core.MODULE_PATH}files/data/zram_bench.json"`);
+            await this.loadBenchReport();
+
+            const statusPage = document.querySelector('.status-page');
+            if (statusPage) {
+                statusPage.innerHTML = this.render();
+                this.afterRender();
+            }
+            Core.showToast(I18n.translate('BENCHMARK_COMPLETED', '压缩算法测试完成'));
+        } catch (error) {
+            console.error('压缩算法测试失败:', error);
+            Core.showToast(I18n.translate('BENCHMARK_ERROR', '压缩算法测试失败'), 'error');
+        } finally {
+            this.benchRunning = false;
+        }
+    },
+
+    formatBenchLabel(result) {
+        return this.escapeHtml(result.level > 0 ? `${result.algorithm}:${result.level}` : result.algorithm);
+    },
+
+    // 渲染压缩算法排名（按最慢核心的解压 p99 排序）
+    renderBenchReport() {
+        const report = this.benchReport;
+        const recommended = report.recommended;
+
+        return `
+            <div class="zram-devices-header">${I18n.translate('BENCHMARK_RESULTS', '压缩算法测试')}</div>
+            ${recommended ? `<div class="status-detail-row">${I18n.translate('BENCHMARK_RECOMMENDED', '推荐')}: ${this.formatBenchLabel(recommended)}</div>` : ''}
+            <div class="device-info-grid">
+                ${report.results.map(result => {
+                    const decomp = Math.min(...result.cores.map(core => core.decomp_mbps));
+                    const comp = Math.min(...result.cores.map(core => core.comp_mbps));
+                    return `
+                        <div class="device-info-item">
+                            <div class="device-info-icon">
+                                <span class="material-symbols-rounded">${recommended && this.formatBenchLabel(recommended) === this.formatBenchLabel(result) ? 'star' : 'speed'}</span>
+                            </div>
+                            <div class="device-info-content">
+                                <div class="device-info-label">#${this.escapeHtml(result.rank)} ${this.formatBenchLabel(result)} · ${result.ratio.toFixed(2)}x</div>
+                                <div class="device-info-value">${I18n.translate('BENCHMARK_DECOMP', '解压')}: ${decomp.toFixed(0)} MB/s · p99 ${result.worst_decomp_p99_us.toFixed(1)} µs</div>
+                                <div class="device-info-value">${I18n.translate('BENCHMARK_COMP', '压缩')}: ${comp.toFixed(0)} MB/s</div>
+                            </div>
+                        </div>
+                    `;
+                }).join('')}
+            </div>
+        `;
+    },
+
     async getDeviceModel() {
         try {
             const result = await Core.execCommand('getprop ro.product.model');
@@ -705,7 +916,7 @@ const StatusPage = {
                         </div>
                         <div class="device-info-content">
                             <div class="device-info-label" data-i18n="${item.label}">${I18n.translate(item.label, item.key)}</div>
-                            <div class="device-info-value">${this.deviceInfo[item.key]}</div>
+                            <div class="device-info-value">${this.escapeHtml(this.deviceInfo[item.key])}</div>
                         </div>
                     </div>
                 `;